@@ -0,0 +1,121 @@
+// batch_solver.cpp
+#include "batch_solver.h"
+#include "log.h"
+#include <thread>
+
+// threadCount 0 stands for one per hardware thread, at least one.
+static unsigned workerCount(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    return threadCount == 0 ? 1 : threadCount;
+}
+
+BatchSolver::BatchSolver(const Grid<char>& maze, unsigned threadCount)
+    : shared(maze), mode(SearchMode::Bidirectional), queueKind(QueueKind::Bucket),
+      pool(workerCount(threadCount)), batch(nullptr), results(nullptr) {
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        workers.emplace_back(new Worker(shared));
+    }
+    LOG_DEBUG("Batch solver started with " << pool.size() << " workers");
+}
+
+MyVector<MyVector<std::pair<int, int>>> BatchSolver::solve(const MyVector<Query>& queries) {
+    return solve(queries.begin(), queries.size());
+}
+
+MyVector<MyVector<std::pair<int, int>>> BatchSolver::solve(const Query* queries, size_t count) {
+    MyVector<MyVector<std::pair<int, int>>> paths(count);
+    if (count == 0) {
+        return paths;
+    }
+
+    // Hand out equal contiguous ranges; stealing evens out the rest
+    size_t share = count / workers.size();
+    size_t extra = count % workers.size();
+    size_t from = 0;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        size_t length = share + (i < extra ? 1 : 0);
+        std::lock_guard<std::mutex> guard(workers[i]->lock);
+        workers[i]->next = from;
+        workers[i]->end = from + length;
+        from += length;
+    }
+
+    batch = queries;
+    results = paths.begin();
+    pool.run([this](unsigned id) { runBatch(id); });
+    batch = nullptr;
+    results = nullptr;
+    return paths;
+}
+
+void BatchSolver::setSearchMode(SearchMode mode) {
+    if (mode != SearchMode::Bidirectional && mode != SearchMode::AStar && mode != SearchMode::BidirectionalAStar) {
+        LOG_ERROR("Error: Batch queries support only the bidirectional and A* modes");
+        return;
+    }
+    this->mode = mode;
+}
+
+SearchMode BatchSolver::getSearchMode() const {
+    return mode;
+}
+
+void BatchSolver::setQueueKind(QueueKind kind) {
+    queueKind = kind;
+}
+
+void BatchSolver::buildLandmarks(int count, size_t memoryBudget) {
+    shared.buildLandmarks(count, memoryBudget);
+}
+
+unsigned BatchSolver::threadCount() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+void BatchSolver::runBatch(unsigned id) {
+    Worker& worker = *workers[id];
+    size_t index;
+    while (takeOwn(worker, index) || steal(id, index)) {
+        results[index] = shared.findShortestPath(worker.workspace, batch[index].first, batch[index].second, mode,
+                                                 queueKind);
+    }
+}
+
+bool BatchSolver::takeOwn(Worker& worker, size_t& index) {
+    std::lock_guard<std::mutex> guard(worker.lock);
+    if (worker.next >= worker.end) {
+        return false;
+    }
+    index = worker.next++;
+    return true;
+}
+
+bool BatchSolver::steal(unsigned thief, size_t& index) {
+    size_t count = workers.size();
+    for (size_t step = 1; step < count; ++step) {
+        Worker& victim = *workers[(thief + step) % count];
+        size_t from, to;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            size_t remaining = victim.end - victim.next;
+            if (remaining == 0) {
+                continue;
+            }
+            // Take the upper half; the victim keeps working from the front
+            from = victim.next + remaining / 2;
+            to = victim.end;
+            victim.end = from;
+        }
+        // Only this thread ever refills its own range, and it is empty here,
+        // so other thieves cannot have touched it in between.
+        Worker& self = *workers[thief];
+        std::lock_guard<std::mutex> guard(self.lock);
+        self.next = from + 1;
+        self.end = to;
+        index = from;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,71 @@
+// batch_solver.h
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include "dekstra.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Solves many independent queries against one maze that does not change
+// while a batch runs. Move masks, component labels and any landmarks are
+// built once and only read by the workers. Each worker owns one
+// SearchWorkspace, allocated once and reused for every query it takes, and
+// runs its queries through the shared solver's dekstra::findShortestPath
+// for workspaces.
+//
+// A batch is split into one contiguous range per worker. A worker that runs
+// out takes the upper half of another worker's remaining range, which keeps
+// all threads busy even when query costs are very uneven.
+class BatchSolver {
+public:
+    typedef std::pair<std::pair<int, int>, std::pair<int, int>> Query;
+
+    // threadCount 0 picks one worker per hardware thread.
+    explicit BatchSolver(const Grid<char>& maze, unsigned threadCount = 0);
+
+    BatchSolver(const BatchSolver&) = delete;
+    BatchSolver& operator=(const BatchSolver&) = delete;
+
+    // Paths come back in the order of the queries; an empty path means the
+    // query has no route. Only one batch runs at a time.
+    MyVector<MyVector<std::pair<int, int>>> solve(const Query* queries, size_t count);
+    MyVector<MyVector<std::pair<int, int>>> solve(const MyVector<Query>& queries);
+
+    // Must not be called while a batch runs. Only Bidirectional, AStar and
+    // BidirectionalAStar are supported; other modes are rejected.
+    void setSearchMode(SearchMode mode);
+    SearchMode getSearchMode() const;
+    void setQueueKind(QueueKind kind);
+    // Shared ALT preprocessing for the A* modes; see dekstra::buildLandmarks.
+    void buildLandmarks(int count, size_t memoryBudget = 0);
+    unsigned threadCount() const;
+
+private:
+    struct Worker {
+        explicit Worker(const dekstra& solver) : workspace(solver.makeWorkspace()), next(0), end(0) {}
+
+        SearchWorkspace workspace;
+        std::mutex lock; // guards next and end
+        size_t next;     // queries [next, end) are still owned by this worker
+        size_t end;
+    };
+
+    dekstra shared; // read-only while a batch runs
+    SearchMode mode;
+    QueueKind queueKind;
+    std::vector<std::unique_ptr<Worker>> workers;
+    ThreadPool pool;
+
+    const Query* batch;
+    MyVector<std::pair<int, int>>* results;
+
+    void runBatch(unsigned id);
+    bool takeOwn(Worker& worker, size_t& index);
+    bool steal(unsigned thief, size_t& index);
+};
+
+#endif // BATCH_SOLVER_H
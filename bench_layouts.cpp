@@ -0,0 +1,97 @@
+// bench_layouts.cpp
+// Times LayoutSearch with every cell layout on the same large maze and
+// checks that they agree on every path length.
+//
+// Usage: bench_layouts [size] [queries] [wall percent]
+//
+// Built by the test project as the bench_layouts target, which is not run
+// by ctest:
+//
+//   cmake -S tests -B build && cmake --build build --target bench_layouts
+//   build/bench_layouts 4000 20 30
+#include "layout_search.h"
+#include "log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+static const int dx[4] = {0, 1, 0, -1};
+static const int dy[4] = {-1, 0, 1, 0};
+
+// Random open grid; every pair of adjacent open cells is connected.
+static Grid<unsigned char> randomMoves(int size, int wallPercent, std::mt19937& rng) {
+    Grid<char> open(size, size);
+    for (size_t i = 0; i < open.size(); ++i) {
+        open[i] = static_cast<int>(rng() % 100) >= wallPercent;
+    }
+    Grid<unsigned char> moves(size, size, 0);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            if (!open(x, y)) {
+                continue;
+            }
+            unsigned char mask = 0;
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = x + dx[dir];
+                int ny = y + dy[dir];
+                if (open.inBounds(nx, ny) && open(nx, ny)) {
+                    mask |= 1 << dir;
+                }
+            }
+            moves(x, y) = mask;
+        }
+    }
+    return moves;
+}
+
+static std::pair<int, int> randomOpenCell(const Grid<unsigned char>& moves, std::mt19937& rng) {
+    while (true) {
+        int x = static_cast<int>(rng() % moves.width());
+        int y = static_cast<int>(rng() % moves.height());
+        if (moves(x, y) != 0) {
+            return {x, y};
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int size = argc > 1 ? std::atoi(argv[1]) : 4000;
+    int queries = argc > 2 ? std::atoi(argv[2]) : 20;
+    int wallPercent = argc > 3 ? std::atoi(argv[3]) : 30;
+
+    std::mt19937 rng(12345);
+    Grid<unsigned char> moves = randomMoves(size, wallPercent, rng);
+    MyVector<std::pair<std::pair<int, int>, std::pair<int, int>>> pairs;
+    for (int i = 0; i < queries; ++i) {
+        pairs.push_back({randomOpenCell(moves, rng), randomOpenCell(moves, rng)});
+    }
+
+    const CellLayout layouts[3] = {CellLayout::RowMajor, CellLayout::Tiled, CellLayout::Morton};
+    const char* names[3] = {"row-major", "tiled 64x64", "morton"};
+    MyVector<size_t> lengths(pairs.size(), 0);
+    bool agree = true;
+    for (int l = 0; l < 3; ++l) {
+        auto built = std::chrono::steady_clock::now();
+        LayoutSearch search(moves, layouts[l]);
+        auto started = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            size_t length = search.findPath(pairs[i].first, pairs[i].second).size();
+            if (l == 0) {
+                lengths[i] = length;
+            } else if (length != lengths[i]) {
+                agree = false;
+            }
+        }
+        auto finished = std::chrono::steady_clock::now();
+        double buildMs = std::chrono::duration<double, std::milli>(started - built).count();
+        double queryMs = std::chrono::duration<double, std::milli>(finished - started).count();
+        std::printf("%-12s build %8.1f ms  %d queries %9.1f ms  (%.2f ms/query, %zu MiB)\n", names[l], buildMs,
+                    queries, queryMs, queryMs / (queries > 0 ? queries : 1), search.memoryUsage() >> 20);
+    }
+    if (!agree) {
+        LOG_ERROR("Error: layouts disagree on path lengths");
+        return 1;
+    }
+    return 0;
+}
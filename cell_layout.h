@@ -0,0 +1,155 @@
+// cell_layout.h
+#ifndef CELL_LAYOUT_H
+#define CELL_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Orders in which the cells of a width x height maze can be stored. Each
+// layout below maps (x, y) to a cell index and steps from a cell to its
+// neighbour in direction N, E, S or W (0..3) without going through (x, y).
+// Steps are only taken through open moves, so they never leave the maze.
+enum class CellLayout {
+    RowMajor, // y * width + x, as Grid stores it
+    Tiled,    // 64x64 blocks, each row-major, blocks in row-major order
+    Morton    // Z-order curve over the maze padded to a power-of-two square
+};
+
+struct RowMajorLayout {
+    static const CellLayout kind = CellLayout::RowMajor;
+
+    RowMajorLayout() : width(0), height(0) {}
+    RowMajorLayout(int width, int height) : width(width), height(height) {}
+
+    size_t size() const {
+        return static_cast<size_t>(width) * height;
+    }
+    size_t index(int x, int y) const {
+        return static_cast<size_t>(y) * width + x;
+    }
+    int xOf(size_t cell) const {
+        return static_cast<int>(cell % width);
+    }
+    int yOf(size_t cell) const {
+        return static_cast<int>(cell / width);
+    }
+    size_t step(size_t cell, int dir) const {
+        switch (dir) {
+        case 0: return cell - width;
+        case 1: return cell + 1;
+        case 2: return cell + width;
+        default: return cell - 1;
+        }
+    }
+
+    int width;
+    int height;
+};
+
+// Vertical steps stay within the block's 4 KiB of move masks for 63 rows
+// out of 64, where row-major storage jumps a whole maze row every time.
+struct TiledLayout {
+    static const CellLayout kind = CellLayout::Tiled;
+    static const int shift = 6;
+    static const int side = 1 << shift;
+    static const size_t blockSize = static_cast<size_t>(side) * side;
+
+    TiledLayout() : width(0), height(0), blocksPerRow(0) {}
+    TiledLayout(int width, int height)
+        : width(width), height(height), blocksPerRow((static_cast<size_t>(width) + side - 1) >> shift) {}
+
+    size_t size() const {
+        return blocksPerRow * ((static_cast<size_t>(height) + side - 1) >> shift) * blockSize;
+    }
+    size_t index(int x, int y) const {
+        size_t block = static_cast<size_t>(y >> shift) * blocksPerRow + (x >> shift);
+        return block * blockSize + (static_cast<size_t>(y & (side - 1)) << shift) + (x & (side - 1));
+    }
+    int xOf(size_t cell) const {
+        return static_cast<int>(((cell / blockSize) % blocksPerRow) << shift) + static_cast<int>(cell & (side - 1));
+    }
+    int yOf(size_t cell) const {
+        return static_cast<int>(((cell / blockSize) / blocksPerRow) << shift) +
+               static_cast<int>((cell >> shift) & (side - 1));
+    }
+    size_t step(size_t cell, int dir) const {
+        size_t column = cell & (side - 1);
+        size_t row = (cell >> shift) & (side - 1);
+        switch (dir) {
+        case 0: return row != 0 ? cell - side : cell - blocksPerRow * blockSize + (side - 1) * side;
+        case 1: return column != side - 1 ? cell + 1 : cell + blockSize - (side - 1);
+        case 2: return row != side - 1 ? cell + side : cell + blocksPerRow * blockSize - (side - 1) * side;
+        default: return column != 0 ? cell - 1 : cell - blockSize + (side - 1);
+        }
+    }
+
+    int width;
+    int height;
+    size_t blocksPerRow;
+};
+
+// x takes the even bits of the index and y the odd ones. A step adds or
+// subtracts one in either set of bits, with the other set forced to carry
+// straight through. Padding to a power-of-two square costs up to 4x the
+// memory on long thin mazes, so this suits roughly square ones.
+struct MortonLayout {
+    static const CellLayout kind = CellLayout::Morton;
+    static const uint64_t xBits = 0x5555555555555555ULL;
+    static const uint64_t yBits = 0xAAAAAAAAAAAAAAAAULL;
+
+    MortonLayout() : width(0), height(0), sideBits(0) {}
+    MortonLayout(int width, int height) : width(width), height(height), sideBits(0) {
+        while ((1 << sideBits) < width || (1 << sideBits) < height) {
+            ++sideBits;
+        }
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(1) << (2 * sideBits);
+    }
+    size_t index(int x, int y) const {
+        return static_cast<size_t>(spread(static_cast<uint32_t>(x)) | (spread(static_cast<uint32_t>(y)) << 1));
+    }
+    int xOf(size_t cell) const {
+        return static_cast<int>(compact(cell));
+    }
+    int yOf(size_t cell) const {
+        return static_cast<int>(compact(cell >> 1));
+    }
+    size_t step(size_t cell, int dir) const {
+        uint64_t z = cell;
+        switch (dir) {
+        case 0: return static_cast<size_t>((((z & yBits) - 2) & yBits) | (z & xBits));
+        case 1: return static_cast<size_t>((((z | yBits) + 1) & xBits) | (z & yBits));
+        case 2: return static_cast<size_t>((((z | xBits) + 2) & yBits) | (z & xBits));
+        default: return static_cast<size_t>((((z & xBits) - 1) & xBits) | (z & yBits));
+        }
+    }
+
+    // Moves bit i of v to bit 2i.
+    static uint64_t spread(uint32_t v) {
+        uint64_t bits = v;
+        bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFULL;
+        bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFULL;
+        bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        bits = (bits | (bits << 2)) & 0x3333333333333333ULL;
+        bits = (bits | (bits << 1)) & 0x5555555555555555ULL;
+        return bits;
+    }
+    // Inverse of spread(): bit 2i of v to bit i.
+    static uint32_t compact(uint64_t v) {
+        uint64_t bits = v & 0x5555555555555555ULL;
+        bits = (bits | (bits >> 1)) & 0x3333333333333333ULL;
+        bits = (bits | (bits >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+        bits = (bits | (bits >> 4)) & 0x00FF00FF00FF00FFULL;
+        bits = (bits | (bits >> 8)) & 0x0000FFFF0000FFFFULL;
+        bits = (bits | (bits >> 16)) & 0x00000000FFFFFFFFULL;
+        return static_cast<uint32_t>(bits);
+    }
+
+    int width;
+    int height;
+    int sideBits;
+};
+
+#endif // CELL_LAYOUT_H
@@ -0,0 +1,259 @@
+// component_index.cpp
+#include "component_index.h"
+#include "log.h"
+#include <algorithm>
+#include <unordered_map>
+
+// Bound to const references by the Grid and MyVector fill constructors
+const int ComponentIndex::noLabel;
+
+ComponentIndex::ComponentIndex() : count(0) {}
+
+void ComponentIndex::build(const Grid<unsigned char>& moves) {
+    labels = Grid<int>(moves.width(), moves.height(), noLabel);
+    size.resize(0);
+    freeLabels.resize(0);
+    count = 0;
+    for (size_t cell = 0; cell < moves.size(); ++cell) {
+        if (labels[cell] == noLabel && moves[cell] != 0) {
+            flood(moves, static_cast<int>(cell), newLabel());
+        }
+    }
+    LOG_DEBUG("Maze has " << count << " connected components");
+}
+
+void ComponentIndex::update(const Grid<unsigned char>& moves, const MyVector<int>& gained,
+                            const MyVector<int>& lost) {
+    if (labels.size() != moves.size()) {
+        build(moves);
+        return;
+    }
+    for (const int cell : lost) {
+        if (moves[cell] == 0) {
+            release(cell);
+            labels[cell] = noLabel;
+        }
+    }
+
+    // New moves join components first. Lost cells may have gained moves as
+    // well, and a newly opened cell starts as a component of its own.
+    const MyVector<int>* changed[2] = {&gained, &lost};
+    for (const MyVector<int>* cells : changed) {
+        for (const int cell : *cells) {
+            if (labels[cell] == noLabel && moves[cell] != 0) {
+                labels[cell] = newLabel();
+                size[labels[cell]] = 1;
+            }
+        }
+    }
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    for (const MyVector<int>* cells : changed) {
+        for (const int cell : *cells) {
+            unsigned char open = moves[cell];
+            for (int dir = 0; dir < 4; ++dir) {
+                if ((open & (1 << dir)) && labels[cell] != labels[cell + offset[dir]]) {
+                    join(moves, cell, cell + offset[dir]);
+                }
+            }
+        }
+    }
+
+    // Now every move joins cells with the same label, but a label may cover
+    // several pieces. Each piece left by a removed edge contains a cell that
+    // lost a move: an endpoint of the edge, or a neighbour of an endpoint
+    // that became a wall. So the lost cells under each label are enough to
+    // find every piece it split into.
+    MyVector<std::pair<int, int>> starts; // (label, cell)
+    for (const int cell : lost) {
+        if (moves[cell] != 0) {
+            starts.push_back({labels[cell], cell});
+        }
+    }
+    std::sort(starts.begin(), starts.end());
+    MyVector<int> group;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        group.push_back(starts[i].second);
+        if (i + 1 == starts.size() || starts[i + 1].first != starts[i].first) {
+            split(moves, group);
+            group.resize(0);
+        }
+    }
+}
+
+int ComponentIndex::componentOf(int cell) const {
+    return labels[cell];
+}
+
+bool ComponentIndex::connected(int a, int b) const {
+    return a == b || (labels[a] != noLabel && labels[a] == labels[b]);
+}
+
+int ComponentIndex::componentCount() const {
+    return count;
+}
+
+int ComponentIndex::newLabel() {
+    ++count;
+    if (!freeLabels.empty()) {
+        int label = freeLabels.end()[-1];
+        freeLabels.pop_back();
+        return label;
+    }
+    size.push_back(0);
+    return static_cast<int>(size.size()) - 1;
+}
+
+void ComponentIndex::release(int cell) {
+    int label = labels[cell];
+    if (label == noLabel) {
+        return;
+    }
+    if (--size[label] == 0) {
+        freeLabels.push_back(label);
+        --count;
+    }
+}
+
+void ComponentIndex::flood(const Grid<unsigned char>& moves, int source, int label) {
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    release(source);
+    labels[source] = label;
+    queue.resize(0);
+    queue.push_back(source);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue.begin()[head];
+        unsigned char open = moves[cell];
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = cell + offset[dir];
+            if ((open & (1 << dir)) && labels[next] != label) {
+                release(next);
+                labels[next] = label;
+                queue.push_back(next);
+            }
+        }
+    }
+    size[label] += static_cast<int>(queue.size());
+}
+
+void ComponentIndex::join(const Grid<unsigned char>& moves, int a, int b) {
+    if (size[labels[a]] < size[labels[b]]) {
+        std::swap(a, b);
+    }
+    // Only cells still carrying b's label are relabelled: b's component may
+    // have pieces split off by this update, and those are left to split().
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    int from = labels[b];
+    int to = labels[a];
+    release(b);
+    labels[b] = to;
+    queue.resize(0);
+    queue.push_back(b);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue.begin()[head];
+        unsigned char open = moves[cell];
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = cell + offset[dir];
+            if ((open & (1 << dir)) && labels[next] == from) {
+                release(next);
+                labels[next] = to;
+                queue.push_back(next);
+            }
+        }
+    }
+    size[to] += static_cast<int>(queue.size());
+}
+
+void ComponentIndex::split(const Grid<unsigned char>& moves, const MyVector<int>& starts) {
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    MyVector<Probe> probes;
+    MyVector<int> merged; // union-find over probe groups
+    std::unordered_map<int, int> owner;
+    for (const int cell : starts) {
+        if (owner.count(cell)) {
+            continue;
+        }
+        int id = static_cast<int>(probes.size());
+        owner[cell] = id;
+        probes.push_back(Probe{MyVector<int>(1, cell), 0, id});
+        merged.push_back(id);
+    }
+    auto root = [&merged](int group) {
+        while (merged[group] != group) {
+            group = merged[group];
+        }
+        return group;
+    };
+
+    // Probes take turns expanding one cell each until at most one group
+    // still has cells left to explore.
+    MyVector<unsigned char> active(probes.size());
+    while (true) {
+        std::fill(active.begin(), active.end(), 0);
+        int running = 0;
+        for (const Probe& probe : probes) {
+            int group = root(probe.group);
+            if (probe.head < probe.cells.size() && !active[group]) {
+                active[group] = 1;
+                ++running;
+            }
+        }
+        if (running <= 1) {
+            break;
+        }
+        for (size_t id = 0; id < probes.size(); ++id) {
+            Probe& probe = probes[id];
+            if (probe.head == probe.cells.size()) {
+                continue;
+            }
+            int cell = probe.cells[probe.head++];
+            unsigned char open = moves[cell];
+            for (int dir = 0; dir < 4; ++dir) {
+                if (!(open & (1 << dir))) {
+                    continue;
+                }
+                int next = cell + offset[dir];
+                auto found = owner.find(next);
+                if (found == owner.end()) {
+                    owner[next] = static_cast<int>(id);
+                    probe.cells.push_back(next);
+                } else {
+                    int a = root(probe.group);
+                    int b = root(probes[found->second].group);
+                    if (a != b) {
+                        merged[b] = a;
+                    }
+                }
+            }
+        }
+    }
+
+    // Finished groups are whole pieces. The one still running, or else the
+    // largest, keeps the old label.
+    MyVector<int> cellsIn(probes.size(), 0);
+    int keep = -1;
+    for (const Probe& probe : probes) {
+        int group = root(probe.group);
+        cellsIn[group] += static_cast<int>(probe.cells.size());
+        if (active[group]) {
+            keep = group;
+        }
+    }
+    if (keep < 0) {
+        keep = static_cast<int>(std::max_element(cellsIn.begin(), cellsIn.end()) - cellsIn.begin());
+    }
+    MyVector<int> relabel(probes.size(), noLabel);
+    for (const Probe& probe : probes) {
+        int group = root(probe.group);
+        if (group == keep) {
+            continue;
+        }
+        if (relabel[group] == noLabel) {
+            relabel[group] = newLabel();
+        }
+        for (const int cell : probe.cells) {
+            release(cell);
+            labels[cell] = relabel[group];
+        }
+        size[relabel[group]] += static_cast<int>(probe.cells.size());
+    }
+}
@@ -0,0 +1,70 @@
+// component_index.h
+#ifndef COMPONENT_INDEX_H
+#define COMPONENT_INDEX_H
+
+#include "grid.h"
+
+// Connected components of the move-mask graph, so a query between two
+// components can be answered "no path" without searching.
+//
+// Each cell with at least one move carries the label of its component
+// itself, so a lookup is a single load and safe from several threads.
+// Cells without moves keep the sentinel label and form no component.
+// Opening a passage between two components relabels the smaller one, so
+// over a run of merges no cell is relabelled more than log2(cells) times.
+//
+// Closing one may split a component. Once every new edge has been merged,
+// searches start from every cell that lost a move and take turns expanding
+// one cell each; searches that meet are merged. Once all but one merged
+// group have run out of cells, those groups are the split-off pieces and
+// get fresh labels, and the remaining piece keeps the old one. An edit
+// that splits nothing therefore costs about the area the searches need to
+// meet around it, and a real split costs a small multiple of the smaller
+// pieces, not the whole component. Labels freed by merges are reused.
+class ComponentIndex {
+public:
+    ComponentIndex();
+
+    void build(const Grid<unsigned char>& moves);
+    // Masks in `gained` only had moves added, masks in `lost` had at least
+    // one removed; a cell in both belongs in `lost`. `moves` already holds
+    // the new masks.
+    void update(const Grid<unsigned char>& moves, const MyVector<int>& gained, const MyVector<int>& lost);
+
+    // Same value for two cells exactly when a path joins them; -1 for a
+    // cell without moves, which is only connected to itself.
+    int componentOf(int cell) const;
+    bool connected(int a, int b) const;
+    int componentCount() const;
+
+private:
+    static const int noLabel = -1;
+
+    // One breadth-first search of the split check in update().
+    struct Probe {
+        MyVector<int> cells;
+        size_t head;
+        int group;
+    };
+
+    Grid<int> labels;
+    // Cells per label; 0 for a label on the free list.
+    MyVector<int> size;
+    MyVector<int> freeLabels;
+    int count;
+    MyVector<int> queue;
+
+    int newLabel();
+    // Takes `cell` out of its component's size before it is relabelled.
+    void release(int cell);
+    void flood(const Grid<unsigned char>& moves, int source, int label);
+    // Merges the components of two cells joined by a new move, relabelling
+    // the smaller one.
+    void join(const Grid<unsigned char>& moves, int a, int b);
+    // Relabels the pieces split off the component of `starts` (every lost
+    // cell of one old component); the piece still being explored when the
+    // others run out keeps its old label.
+    void split(const Grid<unsigned char>& moves, const MyVector<int>& starts);
+};
+
+#endif // COMPONENT_INDEX_H
@@ -0,0 +1,133 @@
+// dead_end_filter.cpp
+#include "dead_end_filter.h"
+#include "log.h"
+
+static int moveCount(unsigned char open) {
+    return (open & 1) + ((open >> 1) & 1) + ((open >> 2) & 1) + ((open >> 3) & 1);
+}
+
+DeadEndFilter::DeadEndFilter() : pruned(0), built(false) {}
+
+void DeadEndFilter::build(Grid<unsigned char>& moves, const Grid<unsigned char>& keep) {
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    full = moves;
+    state = Grid<unsigned char>(moves.width(), moves.height(), 0);
+    trail = Grid<int>();
+    pruned = 0;
+    built = true;
+    MyVector<int> queue;
+    for (size_t cell = 0; cell < moves.size(); ++cell) {
+        if (keep[cell]) {
+            state[cell] |= protectedBit;
+        } else if (moveCount(moves[cell]) == 1) {
+            queue.push_back(static_cast<int>(cell));
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue.begin()[head];
+        unsigned char open = moves[cell];
+        if (moveCount(open) > 1) {
+            continue;
+        }
+        // A lone cell left at the end of a fully cut tree is cut too, so
+        // the check above allows zero moves.
+        state[cell] |= prunedBit;
+        moves[cell] = 0;
+        ++pruned;
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!(open & (1 << dir))) {
+                continue;
+            }
+            int next = cell + offset[dir];
+            moves[next] &= static_cast<unsigned char>(~(1 << ((dir + 2) & 3)));
+            if (moveCount(moves[next]) <= 1 && !(state[next] & (protectedBit | prunedBit))) {
+                queue.push_back(next);
+            }
+        }
+    }
+    LOG_DEBUG("Dead-end filling cut " << pruned << " cells");
+}
+
+void DeadEndFilter::clear() {
+    full = Grid<unsigned char>();
+    state = Grid<unsigned char>();
+    trail = Grid<int>();
+    pruned = 0;
+    built = false;
+}
+
+bool DeadEndFilter::isBuilt() const {
+    return built;
+}
+
+bool DeadEndFilter::isPruned(int cell) const {
+    return built && (state[cell] & prunedBit) != 0;
+}
+
+size_t DeadEndFilter::prunedCount() const {
+    return pruned;
+}
+
+MyVector<int> DeadEndFilter::protect(Grid<unsigned char>& moves, int cell) {
+    MyVector<int> changed;
+    state[cell] |= protectedBit;
+    if (!(state[cell] & prunedBit)) {
+        return changed;
+    }
+    if (trail.size() != moves.size()) {
+        trail = Grid<int>(moves.width(), moves.height());
+    }
+
+    // Breadth-first through cut cells until a kept one turns up. The cut
+    // cells form a tree, so the route found is the only one.
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    MyVector<int> visited;
+    visited.push_back(cell);
+    state[cell] |= visitedBit;
+    trail[cell] = -1;
+    int joint = -1;
+    int kept = -1;
+    for (size_t head = 0; head < visited.size() && joint < 0; ++head) {
+        int at = visited.begin()[head];
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = at + offset[dir];
+            if (!(full[at] & (1 << dir)) || (state[next] & visitedBit)) {
+                continue;
+            }
+            if (!(state[next] & prunedBit)) {
+                joint = at;
+                kept = next;
+                break;
+            }
+            state[next] |= visitedBit;
+            trail[next] = at;
+            visited.push_back(next);
+        }
+    }
+    for (const int at : visited) {
+        state[at] &= static_cast<unsigned char>(~visitedBit);
+    }
+
+    // Restore the branch from the joint back to `cell`. A cell on a cycle
+    // is never cut, so `kept` is the branch's only kept neighbour. With no
+    // kept cell in reach, `cell` comes back alone and without moves.
+    for (int at = joint >= 0 ? joint : cell; at != -1; at = trail[at]) {
+        state[at] &= static_cast<unsigned char>(~prunedBit);
+        --pruned;
+        changed.push_back(at);
+    }
+    if (joint < 0) {
+        changed.resize(0);
+        return changed;
+    }
+    for (const int at : changed) {
+        for (int dir = 0; dir < 4; ++dir) {
+            if ((full[at] & (1 << dir)) && !(state[at + offset[dir]] & prunedBit)) {
+                moves[at] |= static_cast<unsigned char>(1 << dir);
+                moves[at + offset[dir]] |= static_cast<unsigned char>(1 << ((dir + 2) & 3));
+            }
+        }
+    }
+    changed.push_back(kept);
+    return changed;
+}
@@ -0,0 +1,47 @@
+// dead_end_filter.h
+#ifndef DEAD_END_FILTER_H
+#define DEAD_END_FILTER_H
+
+#include "grid.h"
+#include <cstddef>
+
+// Dead-end filling over move masks. An unprotected cell with at most one
+// move cannot lie on a route between two other cells, so it is cut out,
+// which may turn its neighbour into a dead end in turn. What is left is
+// every cycle plus the branches leading to protected cells; in a perfect
+// maze, that is just the paths between them.
+//
+// Cut cells form trees hanging off the kept cells by at most one move, so
+// protecting a cut cell later only has to restore the single branch from
+// it back to the kept cells.
+class DeadEndFilter {
+public:
+    DeadEndFilter();
+
+    // Keeps a copy of `moves` as the unpruned masks, then prunes `moves`
+    // in place. Cells where `keep` is non-zero are protected.
+    void build(Grid<unsigned char>& moves, const Grid<unsigned char>& keep);
+    void clear();
+    bool isBuilt() const;
+
+    // Protects one more cell. If it had been cut, restores the branch
+    // joining it to the kept cells and returns every cell whose mask in
+    // `moves` changed.
+    MyVector<int> protect(Grid<unsigned char>& moves, int cell);
+
+    bool isPruned(int cell) const;
+    size_t prunedCount() const;
+
+private:
+    static const unsigned char prunedBit = 1;
+    static const unsigned char protectedBit = 2;
+    static const unsigned char visitedBit = 4;
+
+    Grid<unsigned char> full;
+    Grid<unsigned char> state;
+    Grid<int> trail; // BFS parents while restoring a branch
+    size_t pruned;
+    bool built;
+};
+
+#endif // DEAD_END_FILTER_H
@@ -1,287 +1,888 @@
 // dekstra.cpp
 #include "dekstra.h"
-#include "iostream"
+#include "distance_field.h"
+#include "log.h"
+#include <cstdlib>
 
-dekstra::dekstra(const MyVector<MyVector<char>>& maze)
-    : maze(maze), width(maze[0].size()), height(maze.size()), finished(false) {
-    // Print maze dimensions for debugging
-    std::cout << "Maze dimensions: " << width << "x" << height << std::endl;
+const int dekstra::dx[4] = {0, 1, 0, -1};
+const int dekstra::dy[4] = {-1, 0, 1, 0};
+
+dekstra::dekstra(const Grid<char>& maze)
+    : maze(maze), width(maze.width()), height(maze.height()),
+      moves(width, height, 0), uniformMoves(true), landmarkCount(0), landmarkBudget(0),
+      jumpPoints(moves), levelSearch(moves), junctions(moves), hierarchy(moves), exactRefinement(false),
+      breadthFirst(FourNeighbors(moves), UnitCells<int>(), moves.size()), planner(moves), treeIndexRequested(false), deadEndsRequested(false), revision(0), goal({-1, -1}), goalFieldRevision(0), goalFieldValid(false),
+      queueKind(QueueKind::Bucket), defaultMode(SearchMode::Bidirectional),
+      mode(SearchMode::Bidirectional), settledStamp(0), finished(false) {
+    offset[0] = -width;
+    offset[1] = 1;
+    offset[2] = width;
+    offset[3] = -1;
+    workspace = SearchWorkspace(width, height, offset);
+    LOG_DEBUG("Maze dimensions: " << width << "x" << height);
+    buildMoves();
+    components.build(moves);
     reset();
 }
 
 void dekstra::reset() {
-    dist = MyVector<MyVector<int>>(height, MyVector<int>(width, std::numeric_limits<int>::max()));
-    distFromEnd = MyVector<MyVector<int>>(height, MyVector<int>(width, std::numeric_limits<int>::max()));
-    prev = MyVector<MyVector<std::pair<int, int>>>(height, MyVector<std::pair<int, int>>(width, {-1, -1}));
-    visited = MyVector<MyVector<bool>>(height, MyVector<bool>(width, false));
-    visitedFromEnd = MyVector<MyVector<bool>>(height, MyVector<bool>(width, false));
-    pq = std::priority_queue<std::pair<int, std::pair<int, int>>,
-                            std::vector<std::pair<int, std::pair<int, int>>>,
-                            std::greater<std::pair<int, std::pair<int, int>>>>();
-    pqFromEnd = std::priority_queue<std::pair<int, std::pair<int, int>>,
-                                   std::vector<std::pair<int, std::pair<int, int>>>,
-                                   std::greater<std::pair<int, std::pair<int, int>>>>();
+    workspace.begin(workspace.pq.getKind());
     finished = false;
 }
 
+void dekstra::setQueueKind(QueueKind kind) {
+    // Takes effect from the next query, which switches the frontiers over
+    queueKind = kind;
+}
+
+QueueKind dekstra::getQueueKind() const {
+    return queueKind;
+}
+
+void dekstra::setSearchMode(SearchMode mode) {
+    defaultMode = mode;
+}
+
+SearchMode dekstra::getSearchMode() const {
+    return defaultMode;
+}
+
 bool dekstra::step() {
-    if (pq.empty() || pqFromEnd.empty() || finished) {
-        finished = true;
+    // Continues the current query with its built-in heuristic. Queries run
+    // with a caller-supplied heuristic have already finished by the time
+    // findShortestPath returns.
+    if (finished) {
         return false;
     }
+    bool advanced;
+    if (mode == SearchMode::Bidirectional) {
+        advanced = advance(ZeroHeuristic());
+    } else if (!landmarks.empty()) {
+        advanced = advance(AltHeuristic{landmarks, width});
+    } else {
+        advanced = advance(ManhattanHeuristic());
+    }
+    finished = !advanced;
+    return advanced;
+}
 
-    if (!pq.empty()) {
-        current = pq.top().second;
-        pq.pop();
+MyVector<std::pair<int, int>> dekstra::findShortestPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    return findShortestPath(start, end, defaultMode);
+}
 
-        if (current.first >= 0 && current.first < width &&
-            current.second >= 0 && current.second < height &&
-            !visited[current.second][current.first]) {
+MyVector<std::pair<int, int>> dekstra::findShortestPath(const std::pair<int, int>& start, const std::pair<int, int>& end,
+                                                        SearchMode mode) {
+    if (!landmarks.empty()) {
+        return findShortestPath(start, end, mode, AltHeuristic{landmarks, width});
+    }
+    return findShortestPath(start, end, mode, ManhattanHeuristic());
+}
 
-            visited[current.second][current.first] = true;
+SearchWorkspace dekstra::makeWorkspace() const {
+    return SearchWorkspace(width, height, offset);
+}
 
-            for (auto& neighbor : getNeighbors(current.first, current.second)) {
-                if (neighbor.first >= 0 && neighbor.first < width &&
-                    neighbor.second >= 0 && neighbor.second < height) {
-                    int newDist = dist[current.second][current.first] + 1;
-                    if (newDist < dist[neighbor.second][neighbor.first]) {
-                        dist[neighbor.second][neighbor.first] = newDist;
-                        prev[neighbor.second][neighbor.first] = current;
-                        pq.push({newDist, neighbor});
-                    }
-                }
-            }
+MyVector<std::pair<int, int>> dekstra::findShortestPath(SearchWorkspace& workspace, const std::pair<int, int>& start,
+                                                        const std::pair<int, int>& end, SearchMode mode,
+                                                        QueueKind kind) const {
+    if (mode != SearchMode::Bidirectional && mode != SearchMode::AStar && mode != SearchMode::BidirectionalAStar) {
+        LOG_ERROR("Error: Workspace queries support only the bidirectional and A* modes");
+        return MyVector<std::pair<int, int>>();
+    }
+    if (!checkEndpoints(start, end)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    seedWorkspace(workspace, static_cast<int>(maze.index(start.first, start.second)),
+                  static_cast<int>(maze.index(end.first, end.second)), queueKindFor(mode, kind));
+    if (mode == SearchMode::Bidirectional) {
+        runQuery(workspace, mode, ZeroHeuristic());
+    } else if (!landmarks.empty()) {
+        runQuery(workspace, mode, AltHeuristic{landmarks, width});
+    } else {
+        runQuery(workspace, mode, ManhattanHeuristic());
+    }
+    return toPath(workspace.tracePath());
+}
+
+MyVector<std::pair<int, int>> dekstra::findNearestGoal(const std::pair<int, int>& start,
+                                                       const MyVector<std::pair<int, int>>& goals) {
+    return findNearestGoal(start, goals, defaultMode);
+}
+
+MyVector<std::pair<int, int>> dekstra::findNearestGoal(const std::pair<int, int>& start,
+                                                       const MyVector<std::pair<int, int>>& goals, SearchMode mode) {
+    if (!isValid(start.first, start.second)) {
+        LOG_ERROR("Error: Start position (" << start.first << "," << start.second << ") is not valid");
+        return MyVector<std::pair<int, int>>();
+    }
+
+    // Every goal becomes a root of the backward tree at distance 0, as if
+    // joined to one virtual target. Meeting any of them closes a route, and
+    // tracePath() stops at whichever goal that route leads to.
+    bool seedGoals = (mode == SearchMode::Bidirectional || mode == SearchMode::BidirectionalAStar ||
+                      mode == SearchMode::ParallelBidirectional);
+    this->mode = seedGoals ? SearchMode::Bidirectional : SearchMode::AStar;
+    finished = false;
+    workspace.begin(queueKindFor(this->mode, queueKind));
+
+    int startCell = static_cast<int>(maze.index(start.first, start.second));
+    workspace.labels.setRoot(startCell);
+    workspace.backwardGoal = startCell;
+    workspace.current = startCell;
+
+    MyVector<std::pair<int, int>> targets;
+    for (const auto& target : goals) {
+        if (!isValid(target.first, target.second)) {
+            LOG_DEBUG("Skipping invalid goal (" << target.first << "," << target.second << ")");
+            continue;
+        }
+        int cell = static_cast<int>(maze.index(target.first, target.second));
+        if (workspace.labelsFromEnd.isReached(cell)) {
+            continue; // Listed twice
         }
+        if (!components.connected(startCell, cell)) {
+            continue; // Cannot be reached, so only widens the search
+        }
+        workspace.labelsFromEnd.setRoot(cell);
+        if (seedGoals) {
+            workspace.pqFromEnd.push(0, cell);
+        }
+        if (cell == startCell) {
+            workspace.offer(0, cell);
+        }
+        targets.push_back(target);
+    }
+    finished = true;
+    if (targets.empty()) {
+        return MyVector<std::pair<int, int>>();
     }
+    workspace.forwardGoal = static_cast<int>(maze.index(targets[0].first, targets[0].second));
+    workspace.currentFromEnd = workspace.forwardGoal;
 
-    if (!pqFromEnd.empty()) {
-        currentFromEnd = pqFromEnd.top().second;
-        pqFromEnd.pop();
+    if (seedGoals) {
+        workspace.pq.push(0, startCell);
+        withCore(workspace, this->mode, [](auto& core) {
+            core.run(ZeroHeuristic());
+            return true;
+        });
+    } else {
+        NearestGoalHeuristic heuristic{targets};
+        workspace.pq.push(heuristic(start.first, start.second, 0, 0), startCell);
+        withCore(workspace, this->mode, [&heuristic](auto& core) {
+            core.run(heuristic);
+            return true;
+        });
+    }
+    return toPath(workspace.tracePath());
+}
 
-        if (currentFromEnd.first >= 0 && currentFromEnd.first < width &&
-            currentFromEnd.second >= 0 && currentFromEnd.second < height &&
-            !visitedFromEnd[currentFromEnd.second][currentFromEnd.first]) {
+MyVector<std::pair<int, int>> dekstra::findNearestExit(const std::pair<int, int>& start) {
+    return findNearestGoal(start, exits);
+}
 
-            visitedFromEnd[currentFromEnd.second][currentFromEnd.first] = true;
+const MyVector<std::pair<int, int>>& dekstra::getExits() const {
+    return exits;
+}
 
-            for (auto& neighbor : getNeighbors(currentFromEnd.first, currentFromEnd.second)) {
-                if (neighbor.first >= 0 && neighbor.first < width &&
-                    neighbor.second >= 0 && neighbor.second < height) {
-                    int newDist = distFromEnd[currentFromEnd.second][currentFromEnd.first] + 1;
-                    if (newDist < distFromEnd[neighbor.second][neighbor.first]) {
-                        distFromEnd[neighbor.second][neighbor.first] = newDist;
-                        pqFromEnd.push({newDist, neighbor});
-                    }
-                }
-            }
+MyVector<std::pair<int, int>> dekstra::findJumpPointPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    if (!uniformMoves) {
+        LOG_DEBUG("Maze has touching terminals, falling back from jump point search");
+        return findShortestPath(start, end, SearchMode::BidirectionalAStar);
+    }
+    if (!beginQuery(start, end, SearchMode::JumpPoint)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    finished = true;
+    return jumpPoints.findPath(start, end);
+}
+
+MyVector<std::pair<int, int>> dekstra::findJunctionPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    if (!beginQuery(start, end, SearchMode::JunctionGraph)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    finished = true;
+    return junctions.findPath(start, end);
+}
+
+MyVector<std::pair<int, int>> dekstra::findHierarchicalPath(const std::pair<int, int>& start,
+                                                            const std::pair<int, int>& end) {
+    if (!hierarchy.isBuilt()) {
+        LOG_ERROR("Error: Hierarchical search needs buildHierarchy() first");
+        return MyVector<std::pair<int, int>>();
+    }
+    if (!beginQuery(start, end, SearchMode::Hierarchical)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    finished = true;
+    return hierarchy.findPath(start, end, exactRefinement);
+}
+
+MyVector<std::pair<int, int>> dekstra::findBreadthFirstPath(const std::pair<int, int>& start,
+                                                            const std::pair<int, int>& end) {
+    if (!beginQuery(start, end, SearchMode::BreadthFirst)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    finished = true;
+    int target = static_cast<int>(maze.index(end.first, end.second));
+    if (!breadthFirst.run(static_cast<int>(maze.index(start.first, start.second)), target)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    return toPath(breadthFirst.tracePath(target));
+}
+
+MyVector<std::pair<int, int>> dekstra::findWeightedPath(const std::pair<int, int>& start, const std::pair<int, int>& end,
+                                                        const Grid<int>& stepCosts) {
+    if (stepCosts.width() != width || stepCosts.height() != height) {
+        LOG_ERROR("Error: Step cost grid is " << stepCosts.width() << "x" << stepCosts.height() << ", maze is "
+                  << width << "x" << height);
+        return MyVector<std::pair<int, int>>();
+    }
+    if (!checkEndpoints(start, end)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    SearchCore<int, FourNeighbors, WeightedCells<int>, HeapPolicy<int>> core(
+        FourNeighbors(moves), WeightedCells<int>{stepCosts.data()}, moves.size());
+    int target = static_cast<int>(maze.index(end.first, end.second));
+    if (!core.run(static_cast<int>(maze.index(start.first, start.second)), target)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    return toPath(core.tracePath(target));
+}
+
+MyVector<std::pair<int, int>> dekstra::findDiagonalPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    if (!checkEndpoints(start, end)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    const double diagonal = 1.4142135623730951;
+    SearchCore<double, EightNeighbors, OctileCells<double>, HeapPolicy<double>> core(
+        EightNeighbors(moves), OctileCells<double>{1.0, diagonal}, moves.size());
+    // Octile distance, the 8-connected counterpart of Manhattan
+    auto octile = [&](int cell) {
+        int across = std::abs(maze.xOf(cell) - end.first);
+        int down = std::abs(maze.yOf(cell) - end.second);
+        return across > down ? across + (diagonal - 1.0) * down : down + (diagonal - 1.0) * across;
+    };
+    int target = static_cast<int>(maze.index(end.first, end.second));
+    if (!core.run(static_cast<int>(maze.index(start.first, start.second)), target, octile)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    return toPath(core.tracePath(target));
+}
+
+MyVector<std::pair<int, int>> dekstra::findIncrementalPath(const std::pair<int, int>& start,
+                                                           const std::pair<int, int>& end) {
+    if (!checkEndpoints(start, end)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    int endCell = static_cast<int>(maze.index(end.first, end.second));
+    if (planner.getGoal() != endCell) {
+        planner.setGoal(endCell);
+    }
+    MyVector<std::pair<int, int>> path = toPath(planner.findPath(static_cast<int>(maze.index(start.first, start.second))));
+    LOG_DEBUG("Incremental replan expanded " << planner.getLastExpansions() << " cells");
+    return path;
+}
+
+MyVector<std::pair<int, int>> dekstra::toPath(const MyVector<int>& cells) const {
+    MyVector<std::pair<int, int>> path;
+    path.reserve(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i) {
+        path.push_back({maze.xOf(cells.begin()[i]), maze.yOf(cells.begin()[i])});
+    }
+    return path;
+}
+
+// State the two threads of a ParallelBidirectional query share. Everything
+// else each side touches (queue, labels) is its
+// own, and the other side reads its distances only for cells it has seen
+// settled through settledBy.
+struct dekstra::ParallelShared {
+    // Best route as (cost << 32) | meet cell, so one atomic min covers both
+    std::atomic<unsigned long long> best;
+    // Smallest key left in each side's queue, published after every
+    // expansion. Keys never decrease, so a stale value is only conservative.
+    std::atomic<int> top[2];
+    std::atomic<bool> stop;
+
+    ParallelShared() : best(~0ULL), stop(false) {
+        top[0] = 0;
+        top[1] = 0;
+    }
+
+    void offer(int cost, int cell) {
+        unsigned long long candidate = (static_cast<unsigned long long>(cost) << 32) | static_cast<unsigned>(cell);
+        unsigned long long seen = best.load();
+        while (candidate < seen && !best.compare_exchange_weak(seen, candidate)) {
+        }
+    }
+
+    int bestCost() const {
+        unsigned long long value = best.load();
+        return value == ~0ULL ? std::numeric_limits<int>::max() : static_cast<int>(value >> 32);
+    }
+};
+
+// Meeting rule of a ParallelBidirectional side: the other side's labels
+// are only read for cells it has published as settled, whose distances are
+// final.
+struct dekstra::ParallelMeeting {
+    dekstra& solver;
+    ParallelShared& shared;
+    unsigned mine;
+    unsigned theirs;
+
+    void settled(int cell, const SearchLabels& side, const SearchLabels& other) {
+        if (solver.markSettled(cell, mine) & theirs) {
+            shared.offer(side.distance(cell) + other.distance(cell), cell);
+        }
+    }
+    void reached(int next, const SearchLabels& side, const SearchLabels& other) {
+        if (solver.isSettledBy(next, theirs)) {
+            shared.offer(side.distance(next) + other.distance(next), next);
+        }
+    }
+};
+
+unsigned dekstra::markSettled(int cell, unsigned side) {
+    // Returns the side bits already set for this query. Both sides use a
+    // sequentially consistent RMW here and a sequentially consistent load in
+    // isSettledBy(), so of two neighbours settled concurrently from opposite
+    // sides at least one side sees the other (Dekker's argument).
+    std::atomic<unsigned>& flags = settledBy[cell];
+    unsigned expected = flags.load();
+    while (true) {
+        unsigned bits = (expected >> 2) == settledStamp ? (expected & 3u) : 0u;
+        if (flags.compare_exchange_weak(expected, (settledStamp << 2) | bits | side)) {
+            return bits;
+        }
+    }
+}
+
+bool dekstra::isSettledBy(int cell, unsigned side) const {
+    unsigned flags = settledBy[cell].load();
+    return (flags >> 2) == settledStamp && (flags & side) != 0;
+}
+
+MyVector<std::pair<int, int>> dekstra::findParallelPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    if (!beginQuery(start, end, SearchMode::ParallelBidirectional)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    finished = true;
+    if (workspace.bestCost == 0) {
+        return toPath(workspace.tracePath());
+    }
+
+    if (!settledBy) {
+        settledBy.reset(new std::atomic<unsigned>[moves.size()]);
+        for (size_t i = 0; i < moves.size(); ++i) {
+            settledBy[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    // The stamp leaves two bits for the sides, so it wraps sooner than the label stamps
+    if (++settledStamp >= (1u << 30)) {
+        for (size_t i = 0; i < moves.size(); ++i) {
+            settledBy[i].store(0, std::memory_order_relaxed);
+        }
+        settledStamp = 1;
+    }
+
+    // Both endpoints count as settled before either thread starts, so a side
+    // reaching the far endpoint always finds it already claimed.
+    int startCell = static_cast<int>(maze.index(start.first, start.second));
+    int endCell = static_cast<int>(maze.index(end.first, end.second));
+    markSettled(startCell, 1);
+    markSettled(endCell, 2);
+    workspace.pq.push(0, startCell);
+    workspace.pqFromEnd.push(0, endCell);
+
+    if (!sidePool) {
+        sidePool.reset(new ThreadPool(2));
+    }
+    ParallelShared shared;
+    withCore(workspace, SearchMode::ParallelBidirectional, [this, &shared](auto& core) {
+        sidePool->run([this, &core, &shared](unsigned side) { runParallelSide(core, side == 0, shared); });
+        return true;
+    });
+
+    if (shared.best.load() != ~0ULL) {
+        workspace.offer(shared.bestCost(), static_cast<int>(shared.best.load() & 0xFFFFFFFFULL));
+    }
+    return toPath(workspace.tracePath());
+}
+
+// One side of a ParallelBidirectional query, expanded by the same
+// BidirectionalCore::expand as the single-threaded modes.
+template <typename Core>
+void dekstra::runParallelSide(const Core& core, bool forward, ParallelShared& shared) {
+    typename Core::Queue& queue = core.frontier(forward);
+    SearchLabels& side = forward ? workspace.labels : workspace.labelsFromEnd;
+    const SearchLabels& other = forward ? workspace.labelsFromEnd : workspace.labels;
+    int& at = forward ? workspace.current : workspace.currentFromEnd;
+    int goal = forward ? workspace.forwardGoal : workspace.backwardGoal;
+    ParallelMeeting meet{*this, shared, forward ? 1u : 2u, forward ? 2u : 1u};
+    std::atomic<int>& myTop = shared.top[forward ? 0 : 1];
+    std::atomic<int>& otherTop = shared.top[forward ? 1 : 0];
+
+    // An empty queue means everything this side can reach is settled, so
+    // every route has been offered already and the best one is final.
+    while (!shared.stop.load() && !queue.empty()) {
+        at = core.expand(queue, side, other, goal, ZeroHeuristic(), meet);
+        if (queue.empty()) {
+            break;
+        }
+        myTop.store(queue.topKey());
+        if (myTop.load() + otherTop.load() >= shared.bestCost()) {
+            break;
+        }
+    }
+    shared.stop.store(true);
+}
+
+MyVector<std::pair<int, int>> dekstra::findLevelPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    if (moves.size() < levelSearch.getMinParallelCells()) {
+        // Too small to split; also spares the parallel workspace
+        return findBreadthFirstPath(start, end);
+    }
+    if (!beginQuery(start, end, SearchMode::LevelSynchronous)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    finished = true;
+    return levelSearch.findPath(start, end);
+}
+
+MyVector<std::pair<int, int>> dekstra::findTreePath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    if (!beginQuery(start, end, mode)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    finished = true;
+    return treeIndex.path(static_cast<int>(maze.index(start.first, start.second)),
+                          static_cast<int>(maze.index(end.first, end.second)));
+}
+
+bool dekstra::buildTreeIndex() {
+    treeIndexRequested = true;
+    return treeIndex.build(moves);
+}
+
+void dekstra::clearTreeIndex() {
+    treeIndexRequested = false;
+    treeIndex.clear();
+}
+
+bool dekstra::hasTreeIndex() const {
+    return treeIndex.isBuilt();
+}
+
+int dekstra::distance(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    if (treeIndex.isBuilt() && maze.inBounds(start.first, start.second) && maze.inBounds(end.first, end.second) &&
+        isValid(start.first, start.second) && isValid(end.first, end.second)) {
+        return treeIndex.distance(static_cast<int>(maze.index(start.first, start.second)),
+                                  static_cast<int>(maze.index(end.first, end.second)));
+    }
+    return static_cast<int>(findShortestPath(start, end).size()) - 1;
+}
+
+void dekstra::buildJumpTable() {
+    jumpPoints.buildJumpTable();
+}
+
+void dekstra::clearJumpTable() {
+    jumpPoints.clearJumpTable();
+}
+
+void dekstra::buildJunctionGraph() {
+    junctions.build();
+}
+
+void dekstra::clearJunctionGraph() {
+    junctions.clear();
+}
+
+void dekstra::buildHierarchy(int clusterSize) {
+    hierarchy.setClusterSize(clusterSize);
+    hierarchy.build();
+    ++revision;
+}
+
+void dekstra::clearHierarchy() {
+    hierarchy.clear();
+    ++revision;
+}
+
+void dekstra::setExactRefinement(bool exact) {
+    exactRefinement = exact;
+}
+
+bool dekstra::getExactRefinement() const {
+    return exactRefinement;
+}
+
+void dekstra::fillDeadEnds() {
+    deadEndsRequested = true;
+    onMazeChanged();
+}
+
+void dekstra::clearDeadEnds() {
+    deadEndsRequested = false;
+    deadEnds.clear();
+    onMazeChanged();
+}
+
+void dekstra::protectCell(const std::pair<int, int>& cell) {
+    if (!maze.inBounds(cell.first, cell.second)) {
+        LOG_ERROR("Error: Protected cell (" << cell.first << "," << cell.second << ") is out of bounds");
+        return;
+    }
+    int index = static_cast<int>(maze.index(cell.first, cell.second));
+    if (protectedCells.size() != maze.size()) {
+        protectedCells = Grid<unsigned char>(width, height, 0);
+    }
+    if (protectedCells[index]) {
+        return; // Already protected, and restored if it had been cut
+    }
+    protectedCells[index] = 1;
+    if (!deadEnds.isBuilt()) {
+        return;
+    }
+    // Restoring a branch only adds moves
+    MyVector<int> restored = deadEnds.protect(moves, index);
+    if (restored.empty()) {
+        return;
+    }
+    components.update(moves, restored, MyVector<int>());
+    planner.updateCells(restored);
+    hierarchy.updateCells(restored);
+    refreshIndexes();
+}
+
+bool dekstra::isPruned(const std::pair<int, int>& cell) const {
+    return maze.inBounds(cell.first, cell.second) &&
+           deadEnds.isPruned(static_cast<int>(maze.index(cell.first, cell.second)));
+}
+
+void dekstra::applyDeadEnds() {
+    Grid<unsigned char> kept = protectedCells.size() == maze.size() ? protectedCells : Grid<unsigned char>(width, height, 0);
+    for (size_t cell = 0; cell < maze.size(); ++cell) {
+        if (maze[cell] == 'I' || maze[cell] == 'O') {
+            kept[cell] = 1;
         }
     }
+    deadEnds.build(moves, kept);
+}
+
+void dekstra::buildLandmarks(int count, size_t memoryBudget) {
+    landmarkCount = count;
+    landmarkBudget = memoryBudget;
+    landmarks.build(moves, count, memoryBudget);
+}
+
+bool dekstra::saveLandmarks(std::ostream& out) const {
+    return landmarks.save(out);
+}
+
+bool dekstra::loadLandmarks(std::istream& in) {
+    if (!landmarks.load(in, moves)) {
+        return false;
+    }
+    landmarkCount = landmarks.landmarkCount();
+    landmarkBudget = 0;
+    return true;
+}
 
-    // Check if paths have met
-    if ((current.first >= 0 && current.first < width && current.second >= 0 && current.second < height &&
-         visitedFromEnd[current.second][current.first]) ||
-        (currentFromEnd.first >= 0 && currentFromEnd.first < width && currentFromEnd.second >= 0 && currentFromEnd.second < height &&
-         visited[currentFromEnd.second][currentFromEnd.first])) {
-        finished = true;
+void dekstra::clearLandmarks() {
+    landmarks = LandmarkTable();
+    landmarkCount = 0;
+}
+
+const LandmarkTable& dekstra::getLandmarks() const {
+    return landmarks;
+}
+
+void dekstra::setGoal(const std::pair<int, int>& goal) {
+    if (goal != this->goal) {
+        this->goal = goal;
+        goalFieldValid = false;
     }
+}
 
+const std::pair<int, int>& dekstra::getGoal() const {
+    return goal;
+}
+
+bool dekstra::updateGoalField() {
+    if (goalFieldValid && goalFieldRevision == revision) {
+        return true;
+    }
+    if (!maze.inBounds(goal.first, goal.second) || !isValid(goal.first, goal.second)) {
+        return false;
+    }
+    // Steps are symmetric, so distances from the goal are distances to it
+    int source = static_cast<int>(maze.index(goal.first, goal.second));
+    if (uniformMoves) {
+        wavefront.compute(moves, source, goalField);
+    } else {
+        computeDistanceField(moves, source, goalField);
+    }
+    goalFieldRevision = revision;
+    goalFieldValid = true;
     return true;
 }
 
-MyVector<std::pair<int, int>> dekstra::findShortestPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
-    // Create empty path to return in case of failures
-    MyVector<std::pair<int, int>> path;
-    
-    // Debug info for start and end positions
-    std::cout << "Finding path from (" << start.first << "," << start.second << ") to ("
-              << end.first << "," << end.second << ")" << std::endl;
-    
-    // Validate start and end points
-    if (start.first < 0 || start.first >= width || 
-        start.second < 0 || start.second >= height ||
-        end.first < 0 || end.first >= width || 
-        end.second < 0 || end.second >= height) {
-        std::cerr << "Error: Start or end point is out of bounds" << std::endl;
-        return path; // Return empty path if start or end is out of bounds
+int dekstra::distanceToGoal(const std::pair<int, int>& from) {
+    if (!maze.inBounds(from.first, from.second) || !updateGoalField()) {
+        return -1;
     }
-    
-    // Print maze cell values at start and end
-    std::cout << "Start cell: " << maze[start.second][start.first] << std::endl;
-    std::cout << "End cell: " << maze[end.second][end.first] << std::endl;
-    
-    // Check if start and end points are valid maze locations
-    if (!isValid(start.first, start.second)) {
-        std::cerr << "Error: Start position (" << start.first << "," << start.second 
-                  << ") is not valid: " << maze[start.second][start.first] << std::endl;
-        return path;
+    return goalField(from.first, from.second);
+}
+
+std::pair<int, int> dekstra::nextStepToGoal(const std::pair<int, int>& from) {
+    int remaining = distanceToGoal(from);
+    if (remaining <= 0) {
+        return remaining == 0 ? from : std::make_pair(-1, -1);
     }
-    
-    if (!isValid(end.first, end.second)) {
-        std::cerr << "Error: End position (" << end.first << "," << end.second 
-                  << ") is not valid: " << maze[end.second][end.first] << std::endl;
+    int cell = static_cast<int>(maze.index(from.first, from.second));
+    unsigned char open = moves[cell];
+    for (int dir = 0; dir < 4; ++dir) {
+        if ((open & (1 << dir)) && goalField[cell + offset[dir]] == remaining - 1) {
+            return {from.first + dx[dir], from.second + dy[dir]};
+        }
+    }
+    return {-1, -1};
+}
+
+MyVector<std::pair<int, int>> dekstra::pathToGoal(const std::pair<int, int>& from) {
+    MyVector<std::pair<int, int>> path;
+    int remaining = distanceToGoal(from);
+    if (remaining < 0) {
         return path;
     }
-    
-    reset();
-    
-    try {
-        dist[start.second][start.first] = 0;
-        distFromEnd[end.second][end.first] = 0;
-        pq.push({0, start});
-        pqFromEnd.push({0, end});
-        
-        // Run algorithm until completion or until queues are empty
-        while (!pq.empty() && !pqFromEnd.empty() && !finished) {
-            step();
+    path.reserve(remaining + 1);
+    std::pair<int, int> at = from;
+    path.push_back(at);
+    // Each step is one closer, so the goal is at most `remaining` steps away;
+    // anything else means the field and the masks disagree.
+    for (int step = 0; step < remaining; ++step) {
+        at = nextStepToGoal(at);
+        if (at.first < 0) {
+            return MyVector<std::pair<int, int>>();
         }
-        
-        // Only attempt path reconstruction if algorithm finished successfully
-        if (finished) {
-            std::pair<int, int> meetPoint = current;
-            
-            // Verify if current point is valid and has been visited
-            if (current.first >= 0 && current.first < width && 
-                current.second >= 0 && current.second < height && 
-                visited[current.second][current.first] && 
-                visitedFromEnd[current.second][current.first]) {
-                // Valid meeting point found
-            } 
-            // Check if currentFromEnd is a better meeting point
-            else if (currentFromEnd.first >= 0 && currentFromEnd.first < width && 
-                     currentFromEnd.second >= 0 && currentFromEnd.second < height && 
-                     visited[currentFromEnd.second][currentFromEnd.first] && 
-                     visitedFromEnd[currentFromEnd.second][currentFromEnd.first]) {
-                meetPoint = currentFromEnd;
-            } else {
-                // No valid meeting point found, check if we can find one
-                bool foundMeetingPoint = false;
-                for (int y = 0; y < height && !foundMeetingPoint; y++) {
-                    for (int x = 0; x < width && !foundMeetingPoint; x++) {
-                        if (visited[y][x] && visitedFromEnd[y][x]) {
-                            meetPoint = {x, y};
-                            foundMeetingPoint = true;
-                        }
-                    }
-                }
-                
-                if (!foundMeetingPoint) {
-                    return path; // No path exists
-                }
+        path.push_back(at);
+    }
+    if (at != goal) {
+        return MyVector<std::pair<int, int>>();
+    }
+    return path;
+}
+
+void dekstra::onMazeChanged() {
+    uniformMoves = true;
+    buildMoves();
+    if (deadEndsRequested) {
+        applyDeadEnds();
+    }
+    components.build(moves);
+    if (planner.getGoal() >= 0) {
+        planner.setGoal(planner.getGoal()); // Every estimate may be stale
+    }
+    if (hierarchy.isBuilt()) {
+        hierarchy.build();
+    }
+    refreshIndexes();
+}
+
+void dekstra::updateCells(const MyVector<std::pair<int, int>>& changed) {
+    MyVector<int> touched;
+    MyVector<int> gained;
+    MyVector<int> lost;
+    if (deadEndsRequested) {
+        // An edit can join or cut off whole pruned branches far from it, so
+        // the masks are rebuilt and filled again. Only cells whose masks
+        // differ afterwards are passed on, as in the local case below.
+        Grid<unsigned char> before(moves);
+        uniformMoves = true;
+        buildMoves();
+        applyDeadEnds();
+        for (size_t cell = 0; cell < moves.size(); ++cell) {
+            if (moves[cell] != before[cell]) {
+                int index = static_cast<int>(cell);
+                (before[cell] & ~moves[cell] ? lost : gained).push_back(index);
+                touched.push_back(index);
             }
-            
-            // Reconstruct path from meetPoint to start
-            MyVector<std::pair<int, int>> pathToStart;
-            std::pair<int, int> at = meetPoint;
-            
-            while (at != std::make_pair(-1, -1)) {
-                if (at.first < 0 || at.first >= width || at.second < 0 || at.second >= height) {
-                    break; // Safety check to prevent out of bounds access
-                }
-                pathToStart.push_back(at);
-                
-                // Check if we've reached the start
-                if (at.first == start.first && at.second == start.second) {
-                    break;
-                }
-                
-                // Safely get the next point by checking bounds
-                if (at.second >= 0 && at.second < prev.size() && 
-                    at.first >= 0 && at.first < prev[at.second].size()) {
-                    at = prev[at.second][at.first];
-                } else {
-                    break; // Break if we would access out of bounds
-                }
+        }
+        components.update(moves, gained, lost);
+        planner.updateCells(touched);
+        hierarchy.updateCells(touched);
+        refreshIndexes();
+        return;
+    }
+    // A cell's mask depends on its own character and its neighbours', so an
+    // edit can change the masks of the cell and the four cells around it.
+    for (const auto& cell : changed) {
+        if (!maze.inBounds(cell.first, cell.second)) {
+            LOG_DEBUG("Skipping out-of-bounds edit (" << cell.first << "," << cell.second << ")");
+            continue;
+        }
+        for (int dir = -1; dir < 4; ++dir) {
+            int x = cell.first + (dir < 0 ? 0 : dx[dir]);
+            int y = cell.second + (dir < 0 ? 0 : dy[dir]);
+            if (!maze.inBounds(x, y)) {
+                continue;
             }
-            
-            // Need to reverse since we went from meetPoint to start
-            std::reverse(pathToStart.begin(), pathToStart.end());
-            
-            // Add pathToStart to final path
-            for (auto& point : pathToStart) {
-                path.push_back(point);
+            unsigned char open = movesAt(x, y);
+            if (open != moves(x, y)) {
+                int index = static_cast<int>(maze.index(x, y));
+                (moves(x, y) & ~open ? lost : gained).push_back(index);
+                moves(x, y) = open;
+                touched.push_back(index);
             }
-            
-            // Only add meetPoint to end path if it's not already the end
-            if (!(meetPoint.first == end.first && meetPoint.second == end.second)) {
-                // Reconstruct path from meetPoint to end
-                at = meetPoint;
-                bool firstPoint = true;
-                
-                while (!(at.first == end.first && at.second == end.second)) {
-                    if (firstPoint) {
-                        firstPoint = false; // Skip the first point since it's already in pathToStart
-                        
-                        // Find next point toward end
-                        int minDist = std::numeric_limits<int>::max();
-                        std::pair<int, int> nextPoint = {-1, -1};
-                        
-                        for (auto& neighbor : getNeighbors(at.first, at.second)) {
-                            if (neighbor.first >= 0 && neighbor.first < width && 
-                                neighbor.second >= 0 && neighbor.second < height && 
-                                visitedFromEnd[neighbor.second][neighbor.first]) {
-                                int d = distFromEnd[neighbor.second][neighbor.first];
-                                if (d < minDist) {
-                                    minDist = d;
-                                    nextPoint = neighbor;
-                                }
-                            }
-                        }
-                        
-                        if (nextPoint.first == -1) break; // No path found
-                        at = nextPoint;
-                    }
-                    
-                    if (at.first < 0 || at.first >= width || at.second < 0 || at.second >= height) {
-                        break; // Safety check to prevent out of bounds access
-                    }
-                    
-                    path.push_back(at);
-                    
-                    // If we've reached the end, break
-                    if (at.first == end.first && at.second == end.second) {
-                        break;
-                    }
-                    
-                    // Find next point toward end
-                    int minDist = std::numeric_limits<int>::max();
-                    std::pair<int, int> nextPoint = {-1, -1};
-                    
-                    for (auto& neighbor : getNeighbors(at.first, at.second)) {
-                        if (neighbor.first >= 0 && neighbor.first < width && 
-                            neighbor.second >= 0 && neighbor.second < height && 
-                            visitedFromEnd[neighbor.second][neighbor.first]) {
-                            int d = distFromEnd[neighbor.second][neighbor.first];
-                            if (d < minDist) {
-                                minDist = d;
-                                nextPoint = neighbor;
-                            }
-                        }
-                    }
-                    
-                    if (nextPoint.first == -1) break; // No path found
-                    at = nextPoint;
+        }
+
+        bool listed = false;
+        for (size_t i = 0; i < exits.size(); ++i) {
+            if (exits[i] == cell) {
+                listed = true;
+                if (maze(cell.first, cell.second) != 'O') {
+                    exits[i] = exits[exits.size() - 1];
+                    exits.pop_back();
                 }
+                break;
             }
         }
-    } catch (const std::exception& e) {
-        // Catch any exceptions that might occur
-        std::cerr << "Exception caught during path finding: " << e.what() << std::endl;
-        return MyVector<std::pair<int, int>>(); // Return empty path
+        if (!listed && maze(cell.first, cell.second) == 'O') {
+            exits.push_back(cell);
+        }
+    }
+    components.update(moves, gained, lost);
+    planner.updateCells(touched);
+    hierarchy.updateCells(touched);
+    refreshIndexes();
+}
+
+void dekstra::refreshIndexes() {
+    ++revision;
+    if (jumpPoints.hasJumpTable()) {
+        jumpPoints.buildJumpTable();
+    }
+    if (treeIndexRequested) {
+        treeIndex.build(moves);
+    }
+    if (junctions.isBuilt()) {
+        junctions.build();
+    }
+    if (!landmarks.empty()) {
+        landmarks.build(moves, landmarkCount, landmarkBudget);
+    }
+    reset();
+    finished = true;
+}
+
+unsigned dekstra::getRevision() const {
+    return revision;
+}
+
+const Grid<unsigned char>& dekstra::getMoves() const {
+    return moves;
+}
+
+int dekstra::componentOf(const std::pair<int, int>& cell) const {
+    if (!maze.inBounds(cell.first, cell.second)) {
+        return -1;
+    }
+    return components.componentOf(static_cast<int>(maze.index(cell.first, cell.second)));
+}
+
+const ComponentIndex& dekstra::getComponents() const {
+    return components;
+}
+
+bool dekstra::checkEndpoints(const std::pair<int, int>& start, const std::pair<int, int>& end) const {
+    LOG_DEBUG("Finding path from (" << start.first << "," << start.second << ") to ("
+              << end.first << "," << end.second << ")");
+
+    if (start.first < 0 || start.first >= width || 
+        start.second < 0 || start.second >= height ||
+        end.first < 0 || end.first >= width || 
+        end.second < 0 || end.second >= height) {
+        LOG_ERROR("Error: Start or end point is out of bounds");
+        return false;
+    }
+
+    LOG_DEBUG("Start cell: " << maze(start.first, start.second));
+    LOG_DEBUG("End cell: " << maze(end.first, end.second));
+
+    if (!isValid(start.first, start.second)) {
+        LOG_ERROR("Error: Start position (" << start.first << "," << start.second 
+                  << ") is not valid: " << maze(start.first, start.second));
+        return false;
     }
     
-    return path;
+    if (!isValid(end.first, end.second)) {
+        LOG_ERROR("Error: End position (" << end.first << "," << end.second 
+                  << ") is not valid: " << maze(end.first, end.second));
+        return false;
+    }
+
+    if (isPruned(start) || isPruned(end)) {
+        LOG_ERROR("Error: Start or end point lies in a filled dead end; protect it first");
+        return false;
+    }
+
+    if (!components.connected(static_cast<int>(maze.index(start.first, start.second)),
+                              static_cast<int>(maze.index(end.first, end.second)))) {
+        LOG_DEBUG("Start and end lie in different components, no path");
+        return false;
+    }
+    return true;
 }
 
-const MyVector<MyVector<bool>>& dekstra::getVisited() const {
-    return visited;
+bool dekstra::beginQuery(const std::pair<int, int>& start, const std::pair<int, int>& end, SearchMode mode) {
+    if (!checkEndpoints(start, end)) {
+        return false;
+    }
+    this->mode = mode;
+    finished = false;
+    seedWorkspace(workspace, static_cast<int>(maze.index(start.first, start.second)),
+                  static_cast<int>(maze.index(end.first, end.second)), queueKindFor(mode, queueKind));
+    return true;
 }
 
-const std::pair<int, int>& dekstra::getCurrent() const {
-    return current;
+void dekstra::seedWorkspace(SearchWorkspace& workspace, int startCell, int endCell, QueueKind kind) const {
+    workspace.begin(kind);
+    workspace.labels.setRoot(startCell);
+    workspace.labelsFromEnd.setRoot(endCell);
+    workspace.forwardGoal = endCell;
+    workspace.backwardGoal = startCell;
+    workspace.current = startCell;
+    workspace.currentFromEnd = endCell;
+    if (startCell == endCell) {
+        workspace.offer(0, startCell);
+    }
 }
 
-const std::pair<int, int>& dekstra::getCurrentFromEnd() const {
-    return currentFromEnd;
+QueueKind dekstra::queueKindFor(SearchMode mode, QueueKind kind) {
+    // A heuristic pushes keys out of order, which a plain FIFO cannot hold
+    if (kind == QueueKind::Fifo && mode != SearchMode::Bidirectional && mode != SearchMode::ParallelBidirectional) {
+        return QueueKind::Bucket;
+    }
+    return kind;
+}
+
+bool dekstra::isVisited(int x, int y) const {
+    return maze.inBounds(x, y) && workspace.labels.isSettled(static_cast<int>(maze.index(x, y)));
+}
+
+std::pair<int, int> dekstra::getCurrent() const {
+    if (workspace.current < 0) {
+        return {-1, -1};
+    }
+    return {maze.xOf(workspace.current), maze.yOf(workspace.current)};
+}
+
+std::pair<int, int> dekstra::getCurrentFromEnd() const {
+    if (workspace.currentFromEnd < 0) {
+        return {-1, -1};
+    }
+    return {maze.xOf(workspace.currentFromEnd), maze.yOf(workspace.currentFromEnd)};
 }
 
 bool dekstra::isValid(int x, int y) const {
@@ -290,90 +891,50 @@ bool dekstra::isValid(int x, int y) const {
         return false;
     }
     
-    char cell = maze[y][x];
+    char cell = maze(x, y);
     bool valid = (cell == '-' || cell == 'I' || cell == 'O');
     
     if (!valid) {
-        // Add debug output for invalid cells
-        std::cout << "Cell at (" << x << "," << y << ") with value '" << cell << "' is not valid for movement" << std::endl;
+        LOG_TRACE("Cell at (" << x << "," << y << ") with value '" << cell << "' is not valid for movement");
     }
     
     return valid;
 }
 
-MyVector<std::pair<int, int>> dekstra::getNeighbors(int x, int y) const {
-    MyVector<std::pair<int, int>> neighbors;
-    int dx[] = {0, 1, 0, -1};
-    int dy[] = {-1, 0, 1, 0};
-
-    // Debug print current cell info
-    std::cout << "Getting neighbors for cell (" << x << "," << y << ") with value: ";
-    if (x >= 0 && x < width && y >= 0 && y < height) {
-        std::cout << maze[y][x] << std::endl;
-    } else {
-        std::cout << "out of bounds" << std::endl;
-    }
-
-    // Special case for start position (I) - check surrounding cells
-    if (x >= 0 && x < width && y >= 0 && y < height && maze[y][x] == 'I') {
-        // Try to find valid moves from entrance
-        for (int i = 0; i < 4; ++i) {
-            int nx = x + dx[i];
-            int ny = y + dy[i];
-            if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                // Check if this is a valid cell to move to
-                std::cout << "  Checking neighbor (" << nx << "," << ny << ") with value: " << maze[ny][nx] << std::endl;
-                if (maze[ny][nx] == '-') {
-                    std::cout << "  Valid neighbor found at (" << nx << "," << ny << ")" << std::endl;
-                    neighbors.push_back({nx, ny});
-                }
-            }
-        }
-        return neighbors;
-    }
-
-    // Special case for end position (O) - also check surrounding cells
-    if (x >= 0 && x < width && y >= 0 && y < height && maze[y][x] == 'O') {
-        for (int i = 0; i < 4; ++i) {
-            int nx = x + dx[i];
-            int ny = y + dy[i];
-            if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                std::cout << "  Checking end neighbor (" << nx << "," << ny << ") with value: " << maze[ny][nx] << std::endl;
-                if (maze[ny][nx] == '-') {
-                    std::cout << "  Valid neighbor for end found at (" << nx << "," << ny << ")" << std::endl;
-                    neighbors.push_back({nx, ny});
-                }
+void dekstra::buildMoves() {
+    // Precompute, for every cell, which of the four directions lead to a
+    // walkable neighbour. Bit i corresponds to (dx[i], dy[i]).
+    exits = MyVector<std::pair<int, int>>();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (maze(x, y) == 'O') {
+                exits.push_back({x, y});
             }
+            moves(x, y) = movesAt(x, y);
         }
-        return neighbors;
     }
+}
 
-    // Normal case - check all four directions
-    for (int i = 0; i < 4; ++i) {
-        int nx = x + dx[i];
-        int ny = y + dy[i];
-        
-        // Check bounds before accessing maze
-        if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-            std::cout << "  Checking normal neighbor (" << nx << "," << ny << ") with value: " << maze[ny][nx] << std::endl;
-        }
-        
-        // Special case - if neighbor is 'I' or 'O', allow movement
-        if (nx >= 0 && nx < width && ny >= 0 && ny < height && 
-            (maze[ny][nx] == 'I' || maze[ny][nx] == 'O')) {
-            std::cout << "  Found entrance/exit at (" << nx << "," << ny << ")" << std::endl;
-            neighbors.push_back({nx, ny});
-        }
-        // Otherwise use normal isValid check
-        else if (isValid(nx, ny)) {
-            std::cout << "  Valid neighbor found at (" << nx << "," << ny << ")" << std::endl;
-            neighbors.push_back({nx, ny});
+unsigned char dekstra::movesAt(int x, int y) {
+    // Entrance and exit cells only connect to plain path cells. Touching
+    // terminals clear uniformMoves; only a full rebuild sets it again.
+    unsigned char open = 0;
+    char cell = maze(x, y);
+    bool terminal = (cell == 'I' || cell == 'O');
+    if (cell == '-' || terminal) {
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = x + dx[dir];
+            int ny = y + dy[dir];
+            if (!maze.inBounds(nx, ny)) {
+                continue;
+            }
+            char next = maze(nx, ny);
+            if (next == '-' || (!terminal && (next == 'I' || next == 'O'))) {
+                open |= 1 << dir;
+            } else if (terminal && (next == 'I' || next == 'O')) {
+                uniformMoves = false;
+            }
         }
     }
-
-    if (neighbors.size() == 0) {
-        std::cout << "No valid neighbors found for (" << x << "," << y << ")" << std::endl;
-    }
-
-    return neighbors;
+    return open;
 }
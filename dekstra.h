@@ -2,43 +2,368 @@
 #ifndef DEKSTRA_H
 #define DEKSTRA_H
 
-#include "myvector.h"
+#include "component_index.h"
+#include "dead_end_filter.h"
+#include "frontier_queue.h"
+#include "grid.h"
+#include "heuristics.h"
+#include "hierarchical_search.h"
+#include "incremental_planner.h"
+#include "jump_point.h"
+#include "junction_graph.h"
+#include "landmarks.h"
+#include "parallel_bfs.h"
+#include "search_core.h"
+#include "search_labels.h"
+#include "thread_pool.h"
+#include "tree_index.h"
+#include "wavefront.h"
+#include <atomic>
+#include <iosfwd>
+#include <memory>
 #include <utility>
 
+enum class SearchMode {
+    Bidirectional,     // blind bidirectional Dijkstra
+    AStar,             // forward A* toward the end point
+    BidirectionalAStar, // A* from both ends, each side aiming at the other
+    JumpPoint,          // jump point search; best on large open areas
+    ParallelBidirectional, // blind bidirectional, each half on its own thread
+    LevelSynchronous,      // breadth-first, each level expanded across all cores
+    BreadthFirst,          // one-sided breadth-first search on SearchCore
+    JunctionGraph,         // Dijkstra over corridors collapsed into weighted edges
+    Hierarchical           // HPA*: search between cluster entrances, then refine;
+                           // needs buildHierarchy()
+};
+
 class dekstra {
 public:
-    dekstra(const MyVector<MyVector<char>>& maze);
+    dekstra(const Grid<char>& maze);
     MyVector<std::pair<int, int>> findShortestPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    MyVector<std::pair<int, int>> findShortestPath(const std::pair<int, int>& start, const std::pair<int, int>& end,
+                                                   SearchMode mode);
+    // The heuristic is ignored in the blind bidirectional modes. It must be
+    // consistent, not merely admissible: settled cells are never reopened,
+    // so a heuristic that drops by more than 1 across a step can return a
+    // longer path. See heuristics.h.
+    template <typename Heuristic>
+    MyVector<std::pair<int, int>> findShortestPath(const std::pair<int, int>& start, const std::pair<int, int>& end,
+                                                   SearchMode mode, const Heuristic& heuristic);
+    // Bidirectional, AStar or BidirectionalAStar query run in a caller's
+    // workspace from makeWorkspace(). Nothing in the solver is written, so
+    // threads with a workspace each may query one solver at the same time
+    // as long as the maze and landmarks stay unchanged. Other modes are
+    // rejected.
+    SearchWorkspace makeWorkspace() const;
+    MyVector<std::pair<int, int>> findShortestPath(SearchWorkspace& workspace, const std::pair<int, int>& start,
+                                                   const std::pair<int, int>& end, SearchMode mode,
+                                                   QueueKind kind) const;
+    // Nearest of several goals from a single search. The returned path ends
+    // at the goal reached and is empty when none is reachable. Bidirectional
+    // modes seed every goal into the backward frontier at once; the others
+    // grow one A* tree from the start and stop when the first goal settles.
+    MyVector<std::pair<int, int>> findNearestGoal(const std::pair<int, int>& start,
+                                                  const MyVector<std::pair<int, int>>& goals);
+    MyVector<std::pair<int, int>> findNearestGoal(const std::pair<int, int>& start,
+                                                  const MyVector<std::pair<int, int>>& goals, SearchMode mode);
+    // Variants run on SearchCore. Both allocate their workspace per call.
+    // stepCosts(x, y) is the cost of entering (x, y) and must not be
+    // negative. Diagonal paths also step between diagonal neighbours when
+    // both cells beside the step are open, at a cost of sqrt(2).
+    MyVector<std::pair<int, int>> findWeightedPath(const std::pair<int, int>& start, const std::pair<int, int>& end,
+                                                   const Grid<int>& stepCosts);
+    MyVector<std::pair<int, int>> findDiagonalPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    // Replanning toward one goal with D* Lite. The first call plans from
+    // scratch; later calls with the same end continue from the previous
+    // search, so after updateCells() or a move of the start only the part
+    // of the plan that changed is repaired.
+    MyVector<std::pair<int, int>> findIncrementalPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    // findNearestGoal over every 'O' cell.
+    MyVector<std::pair<int, int>> findNearestExit(const std::pair<int, int>& start);
+    const MyVector<std::pair<int, int>>& getExits() const;
     bool step();
     void reset();
-    const MyVector<MyVector<bool>>& getVisited() const;
-    const std::pair<int, int>& getCurrent() const;
-    const std::pair<int, int>& getCurrentFromEnd() const;
+    void setQueueKind(QueueKind kind);
+    QueueKind getQueueKind() const;
+    void setSearchMode(SearchMode mode);
+    SearchMode getSearchMode() const;
+
+    // Optional ALT preprocessing. Once landmarks are built or loaded, the
+    // A* modes use them instead of plain Manhattan distance.
+    void buildLandmarks(int count, size_t memoryBudget = 0);
+    bool saveLandmarks(std::ostream& out) const;
+    bool loadLandmarks(std::istream& in);
+    void clearLandmarks();
+    const LandmarkTable& getLandmarks() const;
+
+    // Precomputed jump distances for SearchMode::JumpPoint (JPS+).
+    void buildJumpTable();
+    void clearJumpTable();
+
+    // Corridor-compressed graph for SearchMode::JunctionGraph. Built on the
+    // first query in that mode if not built before, and kept up to date
+    // through maze edits until cleared.
+    void buildJunctionGraph();
+    void clearJunctionGraph();
+
+    // Cluster abstraction for SearchMode::Hierarchical, meant for grids too
+    // large to search flat. Building takes seconds on such grids, so it is
+    // never done implicitly: queries in that mode fail until buildHierarchy()
+    // is called. updateCells() then rebuilds only the clusters whose masks
+    // changed, with or without dead-end filling. Routes are close to
+    // shortest; with exact refinement each one is the shortest through the
+    // clusters it crosses. Building or clearing bumps getRevision(), as the
+    // routes this mode returns change with the clusters.
+    void buildHierarchy(int clusterSize = 32);
+    void clearHierarchy();
+    void setExactRefinement(bool exact);
+    bool getExactRefinement() const;
+
+    // Optional dead-end filling. Dead-end branches with no protected cell
+    // are cut out of the move masks, so every mode searches only what is
+    // left. 'I' and 'O' cells are always protected; protectCell() registers
+    // a query point and restores just the branch leading to it. Endpoints
+    // inside a cut branch have no path. Edits rerun the whole pass.
+    void fillDeadEnds();
+    void clearDeadEnds();
+    void protectCell(const std::pair<int, int>& cell);
+    bool isPruned(const std::pair<int, int>& cell) const;
+
+    // For mazes without cycles, answers every query from an LCA index with
+    // no search at all. Returns false (and keeps searching) otherwise.
+    bool buildTreeIndex();
+    void clearTreeIndex();
+    bool hasTreeIndex() const;
+    // Shortest route length in steps, or -1 when there is none.
+    int distance(const std::pair<int, int>& start, const std::pair<int, int>& end);
+
+    // Goal-directed queries backed by one distance field computed from the
+    // goal. The field is rebuilt lazily, only when the goal or the maze
+    // revision changes; after that each step is O(1).
+    void setGoal(const std::pair<int, int>& goal);
+    const std::pair<int, int>& getGoal() const;
+    int distanceToGoal(const std::pair<int, int>& from);
+    // Neighbour one step closer to the goal; `from` itself when already
+    // there, {-1, -1} when the goal cannot be reached.
+    std::pair<int, int> nextStepToGoal(const std::pair<int, int>& from);
+    // At most distanceToGoal(from) steps; empty when the goal cannot be
+    // reached.
+    MyVector<std::pair<int, int>> pathToGoal(const std::pair<int, int>& from);
+
+    // Must be called after the maze grid passed to the constructor has been
+    // edited. Recomputes the move masks and any built index, and bumps
+    // getRevision().
+    void onMazeChanged();
+    // Same as onMazeChanged() when only the listed cells were edited: move
+    // masks are rebuilt around them alone and the incremental plan is
+    // repaired rather than dropped. With dead-end filling on, the pass
+    // reruns over the whole grid and only cells whose masks changed are
+    // passed on. Built indexes are still rebuilt whole.
+    void updateCells(const MyVector<std::pair<int, int>>& changed);
+    unsigned getRevision() const;
+
+    const Grid<unsigned char>& getMoves() const;
+    // Connected-component label of a cell, kept current through edits.
+    // Queries between different labels return no path without searching;
+    // callers can compare labels to filter a batch up front. -1 when out of
+    // bounds or when the cell has no moves.
+    int componentOf(const std::pair<int, int>& cell) const;
+    const ComponentIndex& getComponents() const;
+    bool isVisited(int x, int y) const;
+    // Cells the last step() expanded on each side; {-1, -1} before any.
+    std::pair<int, int> getCurrent() const;
+    std::pair<int, int> getCurrentFromEnd() const;
 
 private:
-    const MyVector<MyVector<char>>& maze;
+    static const int dx[4];
+    static const int dy[4];
+
+    const Grid<char>& maze;
     int width, height;
-    MyVector<MyVector<int>> dist;
-    MyVector<MyVector<int>> distFromEnd;
-    MyVector<MyVector<std::pair<int, int>>> prev;
-    MyVector<MyVector<bool>> visited;
-    MyVector<MyVector<bool>> visitedFromEnd;
-    std::priority_queue<
-        std::pair<int, std::pair<int, int>>,
-        std::vector<std::pair<int, std::pair<int, int>>>,
-        std::greater<std::pair<int, std::pair<int, int>>>
-    > pq;
-    std::priority_queue<
-        std::pair<int, std::pair<int, int>>,
-        std::vector<std::pair<int, std::pair<int, int>>>,
-        std::greater<std::pair<int, std::pair<int, int>>>
-    > pqFromEnd;
-    std::pair<int, int> current;
-    std::pair<int, int> currentFromEnd;
+
+    // Bit i set when the step (dx[i], dy[i]) from the cell is allowed;
+    // offset[i] is the matching change in flat cell index.
+    Grid<unsigned char> moves;
+    int offset[4];
+    // False when two terminal cells touch: that step is blocked although
+    // both cells are open, which jump point search cannot express.
+    bool uniformMoves;
+    MyVector<std::pair<int, int>> exits;
+    ComponentIndex components;
+
+    // Both search trees, frontiers and best meeting of the running
+    // Bidirectional, AStar, BidirectionalAStar or ParallelBidirectional
+    // query. reset() forgets them in O(1).
+    SearchWorkspace workspace;
+
+    LandmarkTable landmarks;
+    int landmarkCount;
+    size_t landmarkBudget;
+    JumpPointSearch jumpPoints;
+    ParallelBfs levelSearch;
+    JunctionGraph junctions;
+    HierarchicalSearch hierarchy;
+    bool exactRefinement;
+    SearchCore<int, FourNeighbors, UnitCells<int>, FifoPolicy<int>> breadthFirst;
+    IncrementalPlanner planner;
+    TreeIndex treeIndex;
+    bool treeIndexRequested;
+    DeadEndFilter deadEnds;
+    bool deadEndsRequested;
+    Grid<unsigned char> protectedCells; // Non-zero once protectCell() named the cell; allocated on first use
+
+    // Distance field toward `goal`, valid for goalFieldRevision.
+    unsigned revision;
+    std::pair<int, int> goal;
+    Grid<int> goalField;
+    BitWavefront wavefront;
+    unsigned goalFieldRevision;
+    bool goalFieldValid;
+
+    QueueKind queueKind;
+
+    // Mode used when no mode is passed, and mode of the running query.
+    SearchMode defaultMode;
+    SearchMode mode;
+
+    // Cross-thread view of which side settled a cell during a
+    // ParallelBidirectional query: (settledStamp << 2) | side bits. Entries
+    // with an older stamp read as unsettled.
+    std::unique_ptr<std::atomic<unsigned>[]> settledBy;
+    unsigned settledStamp;
+    // The two threads a ParallelBidirectional query runs its sides on,
+    // started by the first such query and kept for the next.
+    std::unique_ptr<ThreadPool> sidePool;
+
     bool finished;
 
+    bool checkEndpoints(const std::pair<int, int>& start, const std::pair<int, int>& end) const;
+    bool beginQuery(const std::pair<int, int>& start, const std::pair<int, int>& end, SearchMode mode);
+    void seedWorkspace(SearchWorkspace& workspace, int startCell, int endCell, QueueKind kind) const;
+    // Frontier kind for a query in `mode` when `kind` is asked for.
+    static QueueKind queueKindFor(SearchMode mode, QueueKind kind);
+    // Calls body(core) with the BidirectionalCore for the workspace's queue
+    // kind and the stop rule of `mode`, so the kind and mode are switched on
+    // once and the loop inside is compiled for each combination.
+    template <typename Body>
+    bool withCore(SearchWorkspace& workspace, SearchMode mode, Body&& body) const;
+    template <QueueKind Kind, typename Body>
+    bool withStopRule(SearchWorkspace& workspace, SearchMode mode, Body&& body) const;
+    // Seeds the frontiers of a query begun by seedWorkspace() and runs it.
+    template <typename Heuristic>
+    void runQuery(SearchWorkspace& workspace, SearchMode mode, const Heuristic& heuristic) const;
+    template <typename Heuristic>
+    bool advance(const Heuristic& heuristic);
+    MyVector<std::pair<int, int>> findTreePath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    struct ParallelShared;
+    struct ParallelMeeting;
+    MyVector<std::pair<int, int>> findParallelPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    template <typename Core>
+    void runParallelSide(const Core& core, bool forward, ParallelShared& shared);
+    unsigned markSettled(int cell, unsigned side);
+    bool isSettledBy(int cell, unsigned side) const;
+    MyVector<std::pair<int, int>> findLevelPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    MyVector<std::pair<int, int>> findJumpPointPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    MyVector<std::pair<int, int>> findJunctionPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    MyVector<std::pair<int, int>> findHierarchicalPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    MyVector<std::pair<int, int>> findBreadthFirstPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    MyVector<std::pair<int, int>> toPath(const MyVector<int>& cells) const;
     bool isValid(int x, int y) const;
-    MyVector<std::pair<int, int>> getNeighbors(int x, int y) const;
+    bool updateGoalField();
+    void buildMoves();
+    unsigned char movesAt(int x, int y);
+    void refreshIndexes();
+    // Prunes the freshly built masks, protecting terminals and registered
+    // cells.
+    void applyDeadEnds();
 };
 
-#endif
\ No newline at end of file
+template <typename Heuristic>
+MyVector<std::pair<int, int>> dekstra::findShortestPath(const std::pair<int, int>& start, const std::pair<int, int>& end,
+                                                        SearchMode mode, const Heuristic& heuristic) {
+    if (treeIndex.isBuilt()) {
+        return findTreePath(start, end);
+    }
+    if (mode == SearchMode::JumpPoint) {
+        return findJumpPointPath(start, end);
+    }
+    if (mode == SearchMode::ParallelBidirectional) {
+        return findParallelPath(start, end);
+    }
+    if (mode == SearchMode::LevelSynchronous) {
+        return findLevelPath(start, end);
+    }
+    if (mode == SearchMode::BreadthFirst) {
+        return findBreadthFirstPath(start, end);
+    }
+    if (mode == SearchMode::JunctionGraph) {
+        return findJunctionPath(start, end);
+    }
+    if (mode == SearchMode::Hierarchical) {
+        return findHierarchicalPath(start, end);
+    }
+    if (!beginQuery(start, end, mode)) {
+        return MyVector<std::pair<int, int>>();
+    }
+    if (mode == SearchMode::Bidirectional) {
+        runQuery(workspace, mode, ZeroHeuristic());
+    } else {
+        runQuery(workspace, mode, heuristic);
+    }
+    finished = true;
+    return toPath(workspace.tracePath());
+}
+
+template <typename Body>
+bool dekstra::withCore(SearchWorkspace& workspace, SearchMode mode, Body&& body) const {
+    switch (workspace.pq.getKind()) {
+    case QueueKind::BinaryHeap:
+        return withStopRule<QueueKind::BinaryHeap>(workspace, mode, body);
+    case QueueKind::Bucket:
+        return withStopRule<QueueKind::Bucket>(workspace, mode, body);
+    case QueueKind::Fifo:
+        return withStopRule<QueueKind::Fifo>(workspace, mode, body);
+    case QueueKind::Radix:
+        return withStopRule<QueueKind::Radix>(workspace, mode, body);
+    }
+    return false;
+}
+
+template <QueueKind Kind, typename Body>
+bool dekstra::withStopRule(SearchWorkspace& workspace, SearchMode mode, Body&& body) const {
+    if (mode == SearchMode::AStar) {
+        BidirectionalCore<Kind, ForwardAStar> core(moves, workspace);
+        return body(core);
+    }
+    if (mode == SearchMode::BidirectionalAStar) {
+        BidirectionalCore<Kind, MeetingAStar> core(moves, workspace);
+        return body(core);
+    }
+    BidirectionalCore<Kind, BlindMeeting> core(moves, workspace);
+    return body(core);
+}
+
+template <typename Heuristic>
+void dekstra::runQuery(SearchWorkspace& workspace, SearchMode mode, const Heuristic& heuristic) const {
+    int startCell = workspace.backwardGoal;
+    int endCell = workspace.forwardGoal;
+    int startX = maze.xOf(startCell), startY = maze.yOf(startCell);
+    int endX = maze.xOf(endCell), endY = maze.yOf(endCell);
+    workspace.pq.push(heuristic(startX, startY, endX, endY), startCell);
+    // Plain A* only grows the forward tree; the end cell acts as the
+    // already-labelled backward side it meets.
+    if (mode != SearchMode::AStar) {
+        workspace.pqFromEnd.push(heuristic(endX, endY, startX, startY), endCell);
+    }
+    withCore(workspace, mode, [&heuristic](auto& core) {
+        core.run(heuristic);
+        return true;
+    });
+}
+
+template <typename Heuristic>
+bool dekstra::advance(const Heuristic& heuristic) {
+    return withCore(workspace, mode, [&heuristic](auto& core) { return core.advance(heuristic); });
+}
+
+#endif
@@ -0,0 +1,28 @@
+// distance_field.cpp
+#include "distance_field.h"
+
+void computeDistanceField(const Grid<unsigned char>& moves, int source, Grid<int>& distances) {
+    if (distances.width() != moves.width() || distances.height() != moves.height()) {
+        distances = Grid<int>(moves.width(), moves.height());
+    }
+    distances.fill(-1);
+
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    MyVector<int> buffer(moves.size());
+    int* queue = buffer.begin();
+    size_t head = 0;
+    size_t tail = 0;
+    distances[source] = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int cell = queue[head++];
+        int next = distances[cell] + 1;
+        unsigned char open = moves[cell];
+        for (int dir = 0; dir < 4; ++dir) {
+            if ((open & (1 << dir)) && distances[cell + offset[dir]] < 0) {
+                distances[cell + offset[dir]] = next;
+                queue[tail++] = cell + offset[dir];
+            }
+        }
+    }
+}
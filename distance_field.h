@@ -0,0 +1,12 @@
+// distance_field.h
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include "grid.h"
+
+// Unit-cost breadth-first distances from source over a grid of direction
+// masks (bit i = step i of N, E, S, W is open). Cells that cannot be reached
+// get -1. distances is resized to match moves.
+void computeDistanceField(const Grid<unsigned char>& moves, int source, Grid<int>& distances);
+
+#endif // DISTANCE_FIELD_H
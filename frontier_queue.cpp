@@ -0,0 +1,134 @@
+// frontier_queue.cpp
+#include "frontier_queue.h"
+
+const int FrontierQueue::emptyKey;
+
+void FrontierBackend<QueueKind::Bucket>::clear() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    count = 0;
+}
+
+void FrontierBackend<QueueKind::Bucket>::grow(int lowKey, int highKey) {
+    size_t size = buckets.size();
+    while (static_cast<size_t>(highKey - lowKey) >= size) {
+        size *= 2;
+    }
+    // Every live key lies in [cursor, maxKey], so redistributing them by the
+    // new modulus keeps each bucket holding a single key.
+    std::vector<std::vector<int>> grown(size);
+    for (int key = cursor; key <= maxKey; ++key) {
+        std::vector<int>& bucket = buckets[key & (buckets.size() - 1)];
+        grown[key & (size - 1)].swap(bucket);
+    }
+    buckets.swap(grown);
+}
+
+void FrontierBackend<QueueKind::Radix>::clear() {
+    for (auto& bucket : radix) {
+        bucket.clear();
+    }
+    count = 0;
+    lastKey = 0;
+}
+
+void FrontierBackend<QueueKind::Radix>::refill() {
+    int i = 1;
+    while (radix[i].empty()) {
+        ++i;
+    }
+    unsigned smallest = static_cast<unsigned>(radix[i].front().first);
+    for (const auto& entry : radix[i]) {
+        smallest = std::min(smallest, static_cast<unsigned>(entry.first));
+    }
+    lastKey = smallest;
+    std::vector<std::pair<int, int>> moved;
+    moved.swap(radix[i]);
+    for (const auto& entry : moved) {
+        radix[bucketOf(static_cast<unsigned>(entry.first), lastKey)].push_back(entry);
+    }
+    moved.clear();
+    moved.swap(radix[i]);
+}
+
+FrontierQueue::FrontierQueue(QueueKind kind) : kind(kind) {}
+
+void FrontierQueue::setKind(QueueKind kind) {
+    clear();
+    this->kind = kind;
+}
+
+QueueKind FrontierQueue::getKind() const {
+    return kind;
+}
+
+void FrontierQueue::push(int key, int cell) {
+    switch (kind) {
+    case QueueKind::BinaryHeap:
+        heap.push(key, cell);
+        break;
+    case QueueKind::Bucket:
+        buckets.push(key, cell);
+        break;
+    case QueueKind::Fifo:
+        fifo.push(key, cell);
+        break;
+    case QueueKind::Radix:
+        radix.push(key, cell);
+        break;
+    }
+}
+
+int FrontierQueue::pop(int& key) {
+    switch (kind) {
+    case QueueKind::BinaryHeap:
+        return heap.pop(key);
+    case QueueKind::Bucket:
+        return buckets.pop(key);
+    case QueueKind::Fifo:
+        return fifo.pop(key);
+    case QueueKind::Radix:
+        return radix.pop(key);
+    }
+    return -1;
+}
+
+int FrontierQueue::topKey() {
+    switch (kind) {
+    case QueueKind::BinaryHeap:
+        return heap.topKey();
+    case QueueKind::Bucket:
+        return buckets.topKey();
+    case QueueKind::Fifo:
+        return fifo.topKey();
+    case QueueKind::Radix:
+        return radix.topKey();
+    }
+    return emptyKey;
+}
+
+bool FrontierQueue::empty() const {
+    return size() == 0;
+}
+
+size_t FrontierQueue::size() const {
+    switch (kind) {
+    case QueueKind::BinaryHeap:
+        return heap.size();
+    case QueueKind::Bucket:
+        return buckets.size();
+    case QueueKind::Fifo:
+        return fifo.size();
+    case QueueKind::Radix:
+        return radix.size();
+    }
+    return 0;
+}
+
+void FrontierQueue::clear() {
+    heap.clear();
+    buckets.clear();
+    fifo.clear();
+    radix.clear();
+}
@@ -0,0 +1,264 @@
+// frontier_queue.h
+#ifndef FRONTIER_QUEUE_H
+#define FRONTIER_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Backends for the search frontier. All of them hand out entries in
+// non-decreasing key order, given the restrictions below.
+enum class QueueKind {
+    BinaryHeap, // general purpose, O(log n) per operation
+    Bucket,     // Dial's circular bucket queue, O(1) amortised; keys must stay
+                // within a sliding window that grows on demand
+    Fifo,       // plain FIFO; keys must be pushed in non-decreasing order
+                // (unit-cost breadth-first search)
+    Radix       // radix heap; keys must never drop below the last popped key
+};
+
+// topKey() of an empty frontier.
+const int emptyFrontierKey = std::numeric_limits<int>::max();
+
+// One backend per kind, each a min-priority queue of (key, cell) entries
+// whose storage is kept across clear(). Searches that know the kind at
+// compile time use these directly (see FrontierPolicy in search_core.h);
+// FrontierQueue picks one at run time.
+template <QueueKind Kind>
+class FrontierBackend;
+
+template <>
+class FrontierBackend<QueueKind::BinaryHeap> {
+public:
+    void push(int key, int cell) {
+        heap.push_back({key, cell});
+        std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<int, int>>());
+    }
+    int pop(int& key) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<int, int>>());
+        key = heap.back().first;
+        int cell = heap.back().second;
+        heap.pop_back();
+        return cell;
+    }
+    int topKey() {
+        return heap.empty() ? emptyFrontierKey : heap.front().first;
+    }
+    bool empty() const {
+        return heap.empty();
+    }
+    size_t size() const {
+        return heap.size();
+    }
+    void clear() {
+        heap.clear();
+    }
+
+private:
+    std::vector<std::pair<int, int>> heap;
+};
+
+template <>
+class FrontierBackend<QueueKind::Bucket> {
+public:
+    FrontierBackend() : buckets(2), count(0), cursor(0), maxKey(0) {}
+
+    void push(int key, int cell) {
+        if (count == 0) {
+            cursor = key;
+            maxKey = key;
+        }
+        int low = std::min(key, cursor);
+        int high = std::max(key, maxKey);
+        if (high - low >= static_cast<int>(buckets.size())) {
+            grow(low, high);
+        }
+        cursor = low;
+        maxKey = high;
+        buckets[key & (buckets.size() - 1)].push_back(cell);
+        ++count;
+    }
+    int pop(int& key) {
+        key = topKey();
+        std::vector<int>& bucket = buckets[cursor & (buckets.size() - 1)];
+        int cell = bucket.back();
+        bucket.pop_back();
+        --count;
+        return cell;
+    }
+    int topKey() {
+        if (count == 0) {
+            return emptyFrontierKey;
+        }
+        while (buckets[cursor & (buckets.size() - 1)].empty()) {
+            ++cursor;
+        }
+        return cursor;
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    size_t size() const {
+        return count;
+    }
+    void clear();
+
+private:
+    // Bucket i holds the keys congruent to i modulo buckets.size().
+    std::vector<std::vector<int>> buckets;
+    size_t count;
+    int cursor;
+    int maxKey;
+
+    void grow(int lowKey, int highKey);
+};
+
+template <>
+class FrontierBackend<QueueKind::Fifo> {
+public:
+    FrontierBackend() : head(0) {}
+
+    void push(int key, int cell) {
+        fifo.push_back({key, cell});
+    }
+    int pop(int& key) {
+        key = fifo[head].first;
+        int cell = fifo[head].second;
+        if (++head == fifo.size()) {
+            fifo.clear();
+            head = 0;
+        }
+        return cell;
+    }
+    int topKey() {
+        return empty() ? emptyFrontierKey : fifo[head].first;
+    }
+    bool empty() const {
+        return head == fifo.size();
+    }
+    size_t size() const {
+        return fifo.size() - head;
+    }
+    void clear() {
+        fifo.clear();
+        head = 0;
+    }
+
+private:
+    std::vector<std::pair<int, int>> fifo;
+    size_t head;
+};
+
+template <>
+class FrontierBackend<QueueKind::Radix> {
+public:
+    FrontierBackend() : count(0), lastKey(0) {}
+
+    void push(int key, int cell) {
+        radix[bucketOf(static_cast<unsigned>(key), lastKey)].push_back({key, cell});
+        ++count;
+    }
+    int pop(int& key) {
+        if (radix[0].empty()) {
+            refill();
+        }
+        key = radix[0].back().first;
+        int cell = radix[0].back().second;
+        radix[0].pop_back();
+        --count;
+        return cell;
+    }
+    int topKey() {
+        if (count == 0) {
+            return emptyFrontierKey;
+        }
+        if (radix[0].empty()) {
+            refill();
+        }
+        return static_cast<int>(lastKey);
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    size_t size() const {
+        return count;
+    }
+    void clear();
+
+private:
+    // Bucket i holds keys whose highest bit differing from lastKey is bit
+    // i - 1; bucket 0 holds keys equal to lastKey.
+    std::vector<std::pair<int, int>> radix[33];
+    size_t count;
+    unsigned lastKey;
+
+    static int bucketOf(unsigned key, unsigned last) {
+        unsigned diff = key ^ last;
+        int bucket = 0;
+        while (diff != 0) {
+            ++bucket;
+            diff >>= 1;
+        }
+        return bucket;
+    }
+    void refill();
+};
+
+// Frontier whose backend is chosen at run time. Each call switches on the
+// kind once and forwards to that backend; a search loop that wants no
+// switch per operation can take backend<Kind>() instead.
+class FrontierQueue {
+public:
+    explicit FrontierQueue(QueueKind kind = QueueKind::Bucket);
+
+    void setKind(QueueKind kind);
+    QueueKind getKind() const;
+
+    void push(int key, int cell);
+    // Removes the entry with the smallest key and returns its cell.
+    int pop(int& key);
+    // Smallest key in the queue, or emptyKey when there is none.
+    int topKey();
+
+    static const int emptyKey = emptyFrontierKey;
+
+    bool empty() const;
+    size_t size() const;
+    void clear();
+
+    // The backend in use; Kind must equal getKind().
+    template <QueueKind Kind>
+    FrontierBackend<Kind>& backend();
+
+private:
+    QueueKind kind;
+    FrontierBackend<QueueKind::BinaryHeap> heap;
+    FrontierBackend<QueueKind::Bucket> buckets;
+    FrontierBackend<QueueKind::Fifo> fifo;
+    FrontierBackend<QueueKind::Radix> radix;
+};
+
+template <>
+inline FrontierBackend<QueueKind::BinaryHeap>& FrontierQueue::backend<QueueKind::BinaryHeap>() {
+    return heap;
+}
+
+template <>
+inline FrontierBackend<QueueKind::Bucket>& FrontierQueue::backend<QueueKind::Bucket>() {
+    return buckets;
+}
+
+template <>
+inline FrontierBackend<QueueKind::Fifo>& FrontierQueue::backend<QueueKind::Fifo>() {
+    return fifo;
+}
+
+template <>
+inline FrontierBackend<QueueKind::Radix>& FrontierQueue::backend<QueueKind::Radix>() {
+    return radix;
+}
+
+#endif // FRONTIER_QUEUE_H
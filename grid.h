@@ -0,0 +1,126 @@
+// grid.h
+#ifndef GRID_H
+#define GRID_H
+
+#include "myvector.h"
+#include <cstddef>
+
+// Flat row-major 2D grid: cell (x, y) lives at index y * width + x.
+// Element access by index or by (x, y) is unchecked; use inBounds() first.
+template <typename T>
+class Grid {
+public:
+    Grid();
+    Grid(int width, int height);
+    Grid(int width, int height, const T& value);
+
+    int width() const;
+    int height() const;
+    size_t size() const;
+
+    bool inBounds(int x, int y) const;
+    size_t index(int x, int y) const;
+    int xOf(size_t index) const;
+    int yOf(size_t index) const;
+
+    T& operator()(int x, int y);
+    const T& operator()(int x, int y) const;
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+
+    void fill(const T& value);
+
+    T* data();
+    const T* data() const;
+
+private:
+    int width_;
+    int height_;
+    MyVector<T> cells_;
+};
+
+template <typename T>
+Grid<T>::Grid() : width_(0), height_(0) {}
+
+template <typename T>
+Grid<T>::Grid(int width, int height)
+    : width_(width), height_(height), cells_(static_cast<size_t>(width) * height) {}
+
+template <typename T>
+Grid<T>::Grid(int width, int height, const T& value)
+    : width_(width), height_(height), cells_(static_cast<size_t>(width) * height, value) {}
+
+template <typename T>
+int Grid<T>::width() const {
+    return width_;
+}
+
+template <typename T>
+int Grid<T>::height() const {
+    return height_;
+}
+
+template <typename T>
+size_t Grid<T>::size() const {
+    return cells_.size();
+}
+
+template <typename T>
+bool Grid<T>::inBounds(int x, int y) const {
+    return x >= 0 && x < width_ && y >= 0 && y < height_;
+}
+
+template <typename T>
+size_t Grid<T>::index(int x, int y) const {
+    return static_cast<size_t>(y) * width_ + x;
+}
+
+template <typename T>
+int Grid<T>::xOf(size_t index) const {
+    return static_cast<int>(index % width_);
+}
+
+template <typename T>
+int Grid<T>::yOf(size_t index) const {
+    return static_cast<int>(index / width_);
+}
+
+template <typename T>
+T& Grid<T>::operator()(int x, int y) {
+    return cells_.begin()[index(x, y)];
+}
+
+template <typename T>
+const T& Grid<T>::operator()(int x, int y) const {
+    return cells_.begin()[index(x, y)];
+}
+
+template <typename T>
+T& Grid<T>::operator[](size_t index) {
+    return cells_.begin()[index];
+}
+
+template <typename T>
+const T& Grid<T>::operator[](size_t index) const {
+    return cells_.begin()[index];
+}
+
+template <typename T>
+void Grid<T>::fill(const T& value) {
+    T* cells = cells_.begin();
+    for (size_t i = 0; i < cells_.size(); ++i) {
+        cells[i] = value;
+    }
+}
+
+template <typename T>
+T* Grid<T>::data() {
+    return cells_.begin();
+}
+
+template <typename T>
+const T* Grid<T>::data() const {
+    return cells_.begin();
+}
+
+#endif // GRID_H
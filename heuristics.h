@@ -0,0 +1,43 @@
+// heuristics.h
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include "myvector.h"
+#include <cstdlib>
+#include <limits>
+#include <utility>
+
+// A* heuristics are called as h(x, y, goalX, goalY) and must return a lower
+// bound on the number of unit steps from (x, y) to the goal that changes by
+// at most 1 per step (admissible and consistent).
+
+struct ZeroHeuristic {
+    int operator()(int, int, int, int) const {
+        return 0;
+    }
+};
+
+struct ManhattanHeuristic {
+    int operator()(int x, int y, int goalX, int goalY) const {
+        return std::abs(x - goalX) + std::abs(y - goalY);
+    }
+};
+
+// Distance to the closest of several goals; the goal passed in is ignored.
+// A minimum of consistent bounds is itself consistent.
+struct NearestGoalHeuristic {
+    const MyVector<std::pair<int, int>>& goals;
+
+    int operator()(int x, int y, int, int) const {
+        int best = std::numeric_limits<int>::max();
+        for (const auto& goal : goals) {
+            int estimate = std::abs(x - goal.first) + std::abs(y - goal.second);
+            if (estimate < best) {
+                best = estimate;
+            }
+        }
+        return best;
+    }
+};
+
+#endif // HEURISTICS_H
@@ -0,0 +1,456 @@
+// hierarchical_search.cpp
+#include "hierarchical_search.h"
+#include "log.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+// A run of crossing moves at least this long gets an entrance at each end
+// instead of one in the middle.
+static const int longRun = 6;
+
+HierarchicalSearch::HierarchicalSearch(const Grid<unsigned char>& moves, int clusterSize)
+    : moves(moves), offset{-moves.width(), 1, moves.width(), -1}, clusterSize(clusterSize), columns(0),
+      rows(0), built(false), localCluster(-1), open(QueueKind::Bucket), expanded(0) {}
+
+void HierarchicalSearch::setClusterSize(int size) {
+    if (size < 1) {
+        LOG_ERROR("Error: Cluster size must be positive, got " << size);
+        return;
+    }
+    clusterSize = size;
+}
+
+int HierarchicalSearch::getClusterSize() const {
+    return clusterSize;
+}
+
+void HierarchicalSearch::build() {
+    columns = (moves.width() + clusterSize - 1) / clusterSize;
+    rows = (moves.height() + clusterSize - 1) / clusterSize;
+    clusters = MyVector<Cluster>(columns * rows);
+    slotOf = MyVector<int>(columns * rows, -1);
+    active.resize(0);
+    slots.clear();
+    localCluster = -1;
+    for (int cluster = 0; cluster < columns * rows; ++cluster) {
+        buildCluster(cluster);
+    }
+    built = true;
+    LOG_DEBUG("Cluster graph: " << columns << "x" << rows << " clusters, " << nodeCount() << " nodes");
+}
+
+void HierarchicalSearch::clear() {
+    clusters = MyVector<Cluster>();
+    slotOf = MyVector<int>();
+    active = MyVector<int>();
+    slots.clear();
+    labels.clear();
+    built = false;
+}
+
+bool HierarchicalSearch::isBuilt() const {
+    return built;
+}
+
+void HierarchicalSearch::updateCells(const MyVector<int>& touched) {
+    if (!built) {
+        return;
+    }
+    MyVector<unsigned char> dirty(clusters.size(), 0);
+    int rebuilt = 0;
+    for (const int cell : touched) {
+        int cluster = clusterOf(cell);
+        if (!dirty[cluster]) {
+            dirty[cluster] = 1;
+            buildCluster(cluster);
+            ++rebuilt;
+        }
+    }
+    LOG_DEBUG("Rebuilt " << rebuilt << " of " << clusters.size() << " clusters");
+}
+
+int HierarchicalSearch::nodeCount() const {
+    int count = 0;
+    for (const Cluster& cluster : clusters) {
+        count += static_cast<int>(cluster.nodes.size());
+    }
+    return count;
+}
+
+size_t HierarchicalSearch::getLastExpanded() const {
+    return expanded;
+}
+
+int HierarchicalSearch::clusterOf(int cell) const {
+    return static_cast<int>(moves.yOf(cell)) / clusterSize * columns + static_cast<int>(moves.xOf(cell)) / clusterSize;
+}
+
+int HierarchicalSearch::localIndex(int cell) const {
+    return static_cast<int>(moves.yOf(cell)) % clusterSize * clusterSize + static_cast<int>(moves.xOf(cell)) % clusterSize;
+}
+
+int HierarchicalSearch::nodeIndex(const Cluster& cluster, int cell) const {
+    const int* found = std::lower_bound(cluster.nodes.begin(), cluster.nodes.end(), cell);
+    return found != cluster.nodes.end() && *found == cell ? static_cast<int>(found - cluster.nodes.begin()) : -1;
+}
+
+void HierarchicalSearch::scanBorder(int cluster, int dir, MyVector<std::pair<int, int>>& out) const {
+    int cx = cluster % columns;
+    int cy = cluster / columns;
+    if ((dir == 1 && cx + 1 >= columns) || (dir == 2 && cy + 1 >= rows)) {
+        return;
+    }
+    int x0 = cx * clusterSize;
+    int y0 = cy * clusterSize;
+    int x1 = std::min(moves.width(), x0 + clusterSize);
+    int y1 = std::min(moves.height(), y0 + clusterSize);
+    // Cells along the border, on this cluster's side
+    int first = static_cast<int>(dir == 1 ? moves.index(x1 - 1, y0) : moves.index(x0, y1 - 1));
+    int step = dir == 1 ? moves.width() : 1;
+    int length = dir == 1 ? y1 - y0 : x1 - x0;
+
+    // A run is a stretch of crossing cells joined to each other along the
+    // border on both sides, so one entrance serves all of it. A step that
+    // is blocked on either side, as between touching 'I' and 'O' cells,
+    // ends the run there.
+    int along = dir == 1 ? 2 : 1;
+    int run = 0;
+    for (int i = 0; i <= length; ++i) {
+        int cell = first + i * step;
+        bool crosses = i < length && (moves[cell] & (1 << dir));
+        bool joined = crosses && run > 0 && (moves[cell - step] & (1 << along)) &&
+                      (moves[cell - step + offset[dir]] & (1 << along));
+        if (crosses && (run == 0 || joined)) {
+            ++run;
+            continue;
+        }
+        if (run >= longRun) {
+            int low = first + (i - run) * step;
+            int high = first + (i - 1) * step;
+            out.push_back({low, low + offset[dir]});
+            out.push_back({high, high + offset[dir]});
+        } else if (run > 0) {
+            int middle = first + (i - run + run / 2) * step;
+            out.push_back({middle, middle + offset[dir]});
+        }
+        run = crosses ? 1 : 0;
+    }
+}
+
+void HierarchicalSearch::buildCluster(int cluster) {
+    // Entrances on all four borders, as (own cell, crossing bit). The west
+    // and north borders are scanned from the neighbour's side, exactly as
+    // that neighbour does, so both always agree.
+    MyVector<std::pair<int, int>> border;
+    MyVector<std::pair<int, int>> found;
+    scanBorder(cluster, 1, border);
+    for (const auto& entrance : border) {
+        found.push_back({entrance.first, 1 << 1});
+    }
+    border.resize(0);
+    scanBorder(cluster, 2, border);
+    for (const auto& entrance : border) {
+        found.push_back({entrance.first, 1 << 2});
+    }
+    if (cluster % columns > 0) {
+        border.resize(0);
+        scanBorder(cluster - 1, 1, border);
+        for (const auto& entrance : border) {
+            found.push_back({entrance.second, 1 << 3});
+        }
+    }
+    if (cluster >= columns) {
+        border.resize(0);
+        scanBorder(cluster - columns, 2, border);
+        for (const auto& entrance : border) {
+            found.push_back({entrance.second, 1 << 0});
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    Cluster& target = clusters[cluster];
+    target.nodes.resize(0);
+    target.crossings.resize(0);
+    for (const auto& entrance : found) {
+        if (!target.nodes.empty() && target.nodes.end()[-1] == entrance.first) {
+            target.crossings.end()[-1] |= static_cast<unsigned char>(entrance.second);
+        } else {
+            target.nodes.push_back(entrance.first);
+            target.crossings.push_back(static_cast<unsigned char>(entrance.second));
+        }
+    }
+
+    // Distances are symmetric, so the search from node i only has to reach
+    // the nodes after it.
+    size_t count = target.nodes.size();
+    target.dist = MyVector<int>(count * count);
+    MyVector<int> own(1, cluster);
+    useClusters(own);
+    localCluster = -1;
+    wanted.assign(static_cast<size_t>(clusterSize) * clusterSize, 0);
+    for (const int node : target.nodes) {
+        wanted[localIndex(node)] = 1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        target.dist[i * count + i] = 0;
+        wanted[localIndex(target.nodes[i])] = 0;
+        if (i + 1 < count) {
+            floodCluster(cluster, target.nodes[i], static_cast<int>(count - 1 - i));
+        }
+        for (size_t j = i + 1; j < count; ++j) {
+            target.dist[i * count + j] = target.dist[j * count + i] = label(target.nodes[j]);
+        }
+    }
+}
+
+void HierarchicalSearch::useClusters(const MyVector<int>& allowed) {
+    for (const int cluster : active) {
+        slotOf[cluster] = -1;
+    }
+    active.resize(0);
+    for (const int cluster : allowed) {
+        if (slotOf[cluster] < 0) {
+            slotOf[cluster] = static_cast<int>(active.size());
+            active.push_back(cluster);
+        }
+    }
+    if (slots.size() < active.size()) {
+        slots.resize(active.size(), std::vector<int>(static_cast<size_t>(clusterSize) * clusterSize));
+    }
+}
+
+int& HierarchicalSearch::label(int cell) {
+    return slots[slotOf[clusterOf(cell)]][localIndex(cell)];
+}
+
+int HierarchicalSearch::flood(int source, int target) {
+    for (size_t slot = 0; slot < active.size(); ++slot) {
+        std::fill(slots[slot].begin(), slots[slot].end(), -1);
+    }
+    queue.resize(0);
+    queue.push_back(source);
+    label(source) = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue.begin()[head];
+        int distance = label(cell);
+        if (cell == target) {
+            return distance;
+        }
+        unsigned char open = moves[cell];
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = cell + offset[dir];
+            if (!(open & (1 << dir)) || slotOf[clusterOf(next)] < 0) {
+                continue;
+            }
+            int& reached = label(next);
+            if (reached < 0) {
+                reached = distance + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return -1;
+}
+
+void HierarchicalSearch::floodCluster(int cluster, int source, int goals) {
+    int x0 = cluster % columns * clusterSize;
+    int y0 = cluster / columns * clusterSize;
+    int w = std::min(moves.width() - x0, clusterSize);
+    int h = std::min(moves.height() - y0, clusterSize);
+    if (localCluster != cluster) {
+        localMoves.assign(static_cast<size_t>(clusterSize) * clusterSize, 0);
+        for (int y = 0; y < h; ++y) {
+            const unsigned char* row = &moves(x0, y0 + y);
+            unsigned char* local = localMoves.data() + y * clusterSize;
+            for (int x = 0; x < w; ++x) {
+                local[x] = row[x];
+            }
+            local[0] &= static_cast<unsigned char>(~(1 << 3));
+            local[w - 1] &= static_cast<unsigned char>(~(1 << 1));
+        }
+        for (int x = 0; x < w; ++x) {
+            localMoves[x] &= static_cast<unsigned char>(~(1 << 0));
+            localMoves[(h - 1) * clusterSize + x] &= static_cast<unsigned char>(~(1 << 2));
+        }
+        localCluster = cluster;
+    }
+
+    const int step[4] = {-clusterSize, 1, clusterSize, -1};
+    std::vector<int>& dist = slots[0];
+    std::fill(dist.begin(), dist.end(), -1);
+    queue.resize(0);
+    int first = localIndex(source);
+    queue.push_back(first);
+    dist[first] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int at = queue.begin()[head];
+        unsigned char open = localMoves[at];
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = at + step[dir];
+            if ((open & (1 << dir)) && dist[next] < 0) {
+                dist[next] = dist[at] + 1;
+                queue.push_back(next);
+                if (goals > 0 && wanted[next] && --goals == 0) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+void HierarchicalSearch::appendTrace(MyVector<std::pair<int, int>>& path, int source, int target) {
+    MyVector<int> back;
+    for (int cell = target; cell != source;) {
+        back.push_back(cell);
+        int distance = label(cell);
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = cell + offset[dir];
+            if ((moves[cell] & (1 << dir)) && slotOf[clusterOf(next)] >= 0 && label(next) == distance - 1) {
+                cell = next;
+                break;
+            }
+        }
+    }
+    for (size_t i = back.size(); i-- > 0;) {
+        path.push_back(at(back.begin()[i]));
+    }
+}
+
+void HierarchicalSearch::relax(int cell, int g, int parent, int endCell) {
+    auto found = labels.find(cell);
+    if (found != labels.end() && found->second.g <= g) {
+        return;
+    }
+    labels[cell] = {g, parent};
+    int h = std::abs(static_cast<int>(moves.xOf(cell)) - static_cast<int>(moves.xOf(endCell))) +
+            std::abs(static_cast<int>(moves.yOf(cell)) - static_cast<int>(moves.yOf(endCell)));
+    open.push(g + h, cell);
+}
+
+MyVector<std::pair<int, int>> HierarchicalSearch::findPath(const std::pair<int, int>& start,
+                                                           const std::pair<int, int>& end, bool exactRefinement) {
+    MyVector<std::pair<int, int>> path;
+    if (!built) {
+        LOG_ERROR("Error: Cluster hierarchy is not built");
+        return path;
+    }
+    int startCell = static_cast<int>(moves.index(start.first, start.second));
+    int endCell = static_cast<int>(moves.index(end.first, end.second));
+    expanded = 0;
+    if (startCell == endCell) {
+        path.push_back(start);
+        return path;
+    }
+    if (moves[startCell] == 0 || moves[endCell] == 0) {
+        return path;
+    }
+    int startCluster = clusterOf(startCell);
+    int endCluster = clusterOf(endCell);
+    const Cluster& source = clusters[startCluster];
+    const Cluster& target = clusters[endCluster];
+
+    // Link the end to the nodes of its cluster, then the start to its own
+    MyVector<int> own(1, endCluster);
+    useClusters(own);
+    floodCluster(endCluster, endCell);
+    MyVector<int> endCost(target.nodes.size());
+    for (size_t j = 0; j < target.nodes.size(); ++j) {
+        endCost[j] = label(target.nodes[j]);
+    }
+    own[0] = startCluster;
+    useClusters(own);
+    floodCluster(startCluster, startCell);
+    int best = std::numeric_limits<int>::max();
+    if (startCluster == endCluster && label(endCell) >= 0) {
+        best = label(endCell); // Within the cluster; leaving it may still be shorter
+    }
+    labels.clear();
+    open.clear();
+    for (const int node : source.nodes) {
+        if (label(node) >= 0) {
+            relax(node, label(node), -1, endCell);
+        }
+    }
+
+    int bestNode = -1;
+    while (!open.empty()) {
+        int key;
+        int cell = open.pop(key);
+        if (key >= best) {
+            break;
+        }
+        const Label current = labels[cell];
+        int h = std::abs(static_cast<int>(moves.xOf(cell)) - end.first) +
+                std::abs(static_cast<int>(moves.yOf(cell)) - end.second);
+        if (key > current.g + h) {
+            continue; // Stale entry left behind by an earlier improvement
+        }
+        ++expanded;
+        int clusterId = clusterOf(cell);
+        const Cluster& cluster = clusters[clusterId];
+        int i = nodeIndex(cluster, cell);
+        size_t count = cluster.nodes.size();
+        if (clusterId == endCluster && endCost[i] >= 0 && current.g + endCost[i] < best) {
+            best = current.g + endCost[i];
+            bestNode = cell;
+        }
+        const int* row = cluster.dist.begin() + i * count;
+        for (size_t j = 0; j < count; ++j) {
+            if (row[j] > 0) {
+                relax(cluster.nodes.begin()[j], current.g + row[j], cell, endCell);
+            }
+        }
+        for (int dir = 0; dir < 4; ++dir) {
+            if (cluster.crossings[i] & (1 << dir)) {
+                relax(cell + offset[dir], current.g + 1, cell, endCell);
+            }
+        }
+    }
+    LOG_DEBUG("Cluster graph search expanded " << expanded << " nodes");
+    if (best == std::numeric_limits<int>::max()) {
+        return path;
+    }
+
+    // Abstract route: start, entrance nodes, end
+    MyVector<int> waypoints;
+    waypoints.push_back(endCell);
+    for (int node = bestNode; node >= 0; node = labels[node].parent) {
+        waypoints.push_back(node);
+    }
+    waypoints.push_back(startCell);
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    path.reserve(best + 1);
+    path.push_back(start);
+    if (exactRefinement) {
+        MyVector<int> corridor;
+        for (const int cell : waypoints) {
+            corridor.push_back(clusterOf(cell));
+        }
+        useClusters(corridor);
+        flood(startCell, endCell);
+        appendTrace(path, startCell, endCell);
+        return path;
+    }
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        int from = waypoints[i - 1];
+        int to = waypoints[i];
+        if (from == to) {
+            continue; // The start or end is a node itself
+        }
+        if (clusterOf(from) != clusterOf(to)) {
+            path.push_back(at(to)); // One step through an entrance
+            continue;
+        }
+        own[0] = clusterOf(from);
+        useClusters(own);
+        floodCluster(own[0], from);
+        appendTrace(path, from, to);
+    }
+    return path;
+}
+
+std::pair<int, int> HierarchicalSearch::at(int cell) const {
+    return {static_cast<int>(moves.xOf(cell)), static_cast<int>(moves.yOf(cell))};
+}
@@ -0,0 +1,114 @@
+// hierarchical_search.h
+#ifndef HIERARCHICAL_SEARCH_H
+#define HIERARCHICAL_SEARCH_H
+
+#include "frontier_queue.h"
+#include "grid.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// HPA*: the grid is cut into square clusters. Where a run of open moves
+// crosses the border of two clusters, one move in the middle (or both end
+// moves, for long runs) becomes an entrance, and its two cells become
+// abstract nodes. A run only continues while its cells are joined along
+// the border on both sides. Inside a cluster, the distance between every pair of its
+// nodes is precomputed with a breadth-first search kept to the cluster.
+//
+// A query links the start and end to the nodes of their own clusters, runs
+// A* over the abstract graph, then refines the node sequence into cells by
+// searching only the clusters the route crosses. Routes are close to
+// shortest but not guaranteed to be: they must pass through entrances.
+// Exact refinement searches the whole corridor of crossed clusters in one
+// go, which gives the shortest route within that corridor.
+//
+// Only per-cluster data is stored, so memory grows with the number of
+// entrances rather than cells.
+class HierarchicalSearch {
+public:
+    explicit HierarchicalSearch(const Grid<unsigned char>& moves, int clusterSize = 32);
+
+    // A changed cluster size takes effect on the next build().
+    void setClusterSize(int size);
+    int getClusterSize() const;
+    void build();
+    void clear();
+    bool isBuilt() const;
+    // Rebuilds only the clusters holding the touched cells. A changed move
+    // across a border touches the cells on both sides, so both clusters
+    // rebuild their entrances. `moves` already holds the new masks.
+    void updateCells(const MyVector<int>& touched);
+
+    // Logs an error and returns no path until build() has run.
+    MyVector<std::pair<int, int>> findPath(const std::pair<int, int>& start, const std::pair<int, int>& end,
+                                           bool exactRefinement = false);
+
+    int nodeCount() const;
+    // Abstract nodes expanded by the last findPath call.
+    size_t getLastExpanded() const;
+
+private:
+    // nodes are sorted cell indexes; crossings[i] has bit d set when
+    // nodes[i] + offset[d] is the other side of one of its entrances;
+    // dist[i * nodes.size() + j] is -1 when nodes j is out of reach of
+    // nodes i inside the cluster.
+    struct Cluster {
+        MyVector<int> nodes;
+        MyVector<unsigned char> crossings;
+        MyVector<int> dist;
+    };
+    struct Label {
+        int g;
+        int parent; // -1 when linked straight to the start
+    };
+
+    const Grid<unsigned char>& moves;
+    int offset[4];
+    int clusterSize;
+    int columns;
+    int rows;
+    bool built;
+    MyVector<Cluster> clusters;
+
+    // Breadth-first labels, one block of clusterSize^2 cells per cluster
+    // the search may enter; slotOf is -1 for the others.
+    MyVector<int> slotOf;
+    MyVector<int> active;
+    std::vector<std::vector<int>> slots;
+    MyVector<int> queue;
+    // Masks of one cluster with the moves leaving it cleared, indexed like
+    // the label blocks, so a search inside it needs no bounds tests.
+    std::vector<unsigned char> localMoves;
+    int localCluster;
+    // Node cells, by local index, still wanted by the searches that fill
+    // a cluster's distance table.
+    std::vector<unsigned char> wanted;
+
+    std::unordered_map<int, Label> labels;
+    FrontierQueue open;
+    size_t expanded;
+
+    int clusterOf(int cell) const;
+    int localIndex(int cell) const;
+    int nodeIndex(const Cluster& cluster, int cell) const;
+    // Entrances across the east (dir 1) or south (dir 2) border of
+    // `cluster`, as pairs of (own cell, neighbour's cell).
+    void scanBorder(int cluster, int dir, MyVector<std::pair<int, int>>& out) const;
+    void buildCluster(int cluster);
+
+    void useClusters(const MyVector<int>& allowed);
+    int& label(int cell);
+    // Breadth-first from source through the allowed clusters; stops early
+    // once target (if not -1) is reached. Returns its distance or -1.
+    int flood(int source, int target);
+    // Same as flood(source, -1) when `cluster`, holding source, is the only
+    // one allowed. With goals > 0 it stops once that many cells marked in
+    // `wanted` are reached.
+    void floodCluster(int cluster, int source, int goals = 0);
+    // Appends the cells after `source` up to `target` from the last flood.
+    void appendTrace(MyVector<std::pair<int, int>>& path, int source, int target);
+    void relax(int cell, int g, int parent, int endCell);
+    std::pair<int, int> at(int cell) const;
+};
+
+#endif // HIERARCHICAL_SEARCH_H
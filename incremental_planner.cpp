@@ -0,0 +1,242 @@
+// incremental_planner.cpp
+#include "incremental_planner.h"
+#include "log.h"
+#include <cstdlib>
+#include <limits>
+
+// Large enough to mean "no route", small enough that adding a step or a
+// heuristic cannot overflow.
+const int IncrementalPlanner::unreachable = std::numeric_limits<int>::max() / 4;
+
+IncrementalPlanner::IncrementalPlanner(const Grid<unsigned char>& moves)
+    : moves(moves), offset{-moves.width(), 1, moves.width(), -1}, goal(-1), lastStart(-1), km(0), lastExpansions(0) {}
+
+void IncrementalPlanner::setGoal(int goal) {
+    this->goal = goal;
+    lastStart = -1;
+    km = 0;
+    // Allocated on first use: a solver that never replans pays nothing
+    if (g.size() != moves.size()) {
+        g = Grid<int>(moves.width(), moves.height());
+        rhs = Grid<int>(moves.width(), moves.height());
+        heapIndex = Grid<int>(moves.width(), moves.height());
+    }
+    g.fill(unreachable);
+    rhs.fill(unreachable);
+    heapIndex.fill(-1);
+    heap.clear();
+    rhs[goal] = 0;
+}
+
+int IncrementalPlanner::getGoal() const {
+    return goal;
+}
+
+size_t IncrementalPlanner::getLastExpansions() const {
+    return lastExpansions;
+}
+
+MyVector<int> IncrementalPlanner::findPath(int start) {
+    MyVector<int> path;
+    if (goal < 0) {
+        LOG_ERROR("Error: Incremental planner has no goal");
+        return path;
+    }
+    if (lastStart < 0) {
+        lastStart = start;
+        push(goal, keyOf(goal, start));
+    } else if (start != lastStart) {
+        km += heuristic(lastStart, start);
+        lastStart = start;
+    }
+    computeShortestPath(start);
+    if (g[start] >= unreachable) {
+        return path;
+    }
+
+    // Descend g one step at a time; every neighbour on a shortest route is
+    // exactly one closer to the goal.
+    path.reserve(g[start] + 1);
+    path.push_back(start);
+    for (int at = start; at != goal;) {
+        unsigned char open = moves[at];
+        int best = -1;
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = at + offset[dir];
+            if ((open & (1 << dir)) && (best < 0 || g[next] < g[best])) {
+                best = next;
+            }
+        }
+        if (best < 0 || g[best] >= g[at]) {
+            LOG_ERROR("Error: Incremental planner left an inconsistent route at cell " << at);
+            return MyVector<int>();
+        }
+        at = best;
+        path.push_back(at);
+    }
+    return path;
+}
+
+void IncrementalPlanner::updateCells(const MyVector<int>& changed) {
+    if (lastStart < 0) {
+        return; // Nothing planned yet, so nothing to repair
+    }
+    int width = moves.width();
+    for (size_t i = 0; i < changed.size(); ++i) {
+        int cell = changed.begin()[i];
+        int x = moves.xOf(cell);
+        int y = moves.yOf(cell);
+        // The cell's own lookahead and its neighbours' may all have changed;
+        // neighbours are taken from the grid, not the masks, so cells that
+        // just lost their connection are included.
+        const int around[5] = {cell, cell - width, cell + 1, cell + width, cell - 1};
+        const bool inside[5] = {true, y > 0, x + 1 < width, y + 1 < moves.height(), x > 0};
+        for (int k = 0; k < 5; ++k) {
+            if (inside[k] && around[k] != goal) {
+                rhs[around[k]] = lookahead(around[k]);
+                updateVertex(around[k], lastStart);
+            }
+        }
+    }
+}
+
+bool IncrementalPlanner::less(const Key& a, const Key& b) {
+    return a.primary < b.primary || (a.primary == b.primary && a.secondary < b.secondary);
+}
+
+IncrementalPlanner::Key IncrementalPlanner::keyOf(int cell, int start) const {
+    int best = g[cell] < rhs[cell] ? g[cell] : rhs[cell];
+    return {best + heuristic(start, cell) + km, best};
+}
+
+int IncrementalPlanner::heuristic(int from, int to) const {
+    return std::abs(moves.xOf(from) - moves.xOf(to)) + std::abs(moves.yOf(from) - moves.yOf(to));
+}
+
+int IncrementalPlanner::lookahead(int cell) const {
+    int best = unreachable;
+    unsigned char open = moves[cell];
+    for (int dir = 0; dir < 4; ++dir) {
+        if ((open & (1 << dir)) && g[cell + offset[dir]] + 1 < best) {
+            best = g[cell + offset[dir]] + 1;
+        }
+    }
+    return best;
+}
+
+void IncrementalPlanner::updateVertex(int cell, int start) {
+    if (g[cell] != rhs[cell]) {
+        push(cell, keyOf(cell, start));
+    } else if (heapIndex[cell] >= 0) {
+        remove(cell);
+    }
+}
+
+void IncrementalPlanner::computeShortestPath(int start) {
+    lastExpansions = 0;
+    while (!heap.empty() && (less(heap[0].key, keyOf(start, start)) || rhs[start] != g[start])) {
+        ++lastExpansions;
+        int cell = heap[0].cell;
+        Key current = keyOf(cell, start);
+        if (less(heap[0].key, current)) {
+            push(cell, current); // Queued before the start last moved
+            continue;
+        }
+
+        unsigned char open = moves[cell];
+        if (g[cell] > rhs[cell]) {
+            // Overconsistent: the estimate improves and is now final
+            g[cell] = rhs[cell];
+            remove(cell);
+            for (int dir = 0; dir < 4; ++dir) {
+                int next = cell + offset[dir];
+                if ((open & (1 << dir)) && next != goal && g[cell] + 1 < rhs[next]) {
+                    rhs[next] = g[cell] + 1;
+                    updateVertex(next, start);
+                }
+            }
+        } else {
+            // Underconsistent: the old estimate was too low. Raise it and
+            // let every neighbour that relied on it look again.
+            int old = g[cell];
+            g[cell] = unreachable;
+            for (int dir = 0; dir < 4; ++dir) {
+                int next = cell + offset[dir];
+                if ((open & (1 << dir)) && next != goal && rhs[next] == old + 1) {
+                    rhs[next] = lookahead(next);
+                    updateVertex(next, start);
+                }
+            }
+            if (cell != goal) {
+                rhs[cell] = lookahead(cell);
+            }
+            updateVertex(cell, start);
+        }
+    }
+    LOG_DEBUG("Incremental planner expanded " << lastExpansions << " cells");
+}
+
+void IncrementalPlanner::push(int cell, const Key& key) {
+    int index = heapIndex[cell];
+    if (index < 0) {
+        heap.push_back({key, cell});
+        index = static_cast<int>(heap.size()) - 1;
+        heapIndex[cell] = index;
+        siftUp(index);
+        return;
+    }
+    heap[index].key = key;
+    siftUp(index);
+    siftDown(heapIndex[cell]);
+}
+
+void IncrementalPlanner::remove(int cell) {
+    int index = heapIndex[cell];
+    heapIndex[cell] = -1;
+    Entry last = heap.back();
+    heap.pop_back();
+    if (index == static_cast<int>(heap.size())) {
+        return;
+    }
+    place(index, last);
+    siftUp(index);
+    siftDown(heapIndex[last.cell]);
+}
+
+void IncrementalPlanner::place(int index, const Entry& entry) {
+    heap[index] = entry;
+    heapIndex[entry.cell] = index;
+}
+
+void IncrementalPlanner::siftUp(int index) {
+    Entry entry = heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!less(entry.key, heap[parent].key)) {
+            break;
+        }
+        place(index, heap[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+void IncrementalPlanner::siftDown(int index) {
+    Entry entry = heap[index];
+    int count = static_cast<int>(heap.size());
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && less(heap[child + 1].key, heap[child].key)) {
+            ++child;
+        }
+        if (!less(heap[child].key, entry.key)) {
+            break;
+        }
+        place(index, heap[child]);
+        index = child;
+    }
+    place(index, entry);
+}
@@ -0,0 +1,73 @@
+// incremental_planner.h
+#ifndef INCREMENTAL_PLANNER_H
+#define INCREMENTAL_PLANNER_H
+
+#include "grid.h"
+#include <cstddef>
+#include <vector>
+
+// D* Lite (Koenig and Likhachev) over the solver's move masks. The search
+// runs backward from the goal, so the agent's start can move freely. When
+// some masks change, only the cells next to the change are re-queued, and
+// the next findPath repairs the g-values they affect. Replanning after a
+// small edit therefore touches a region around the edit, not the whole maze.
+//
+// g[s] is the current distance estimate from s to the goal and rhs[s] its
+// one-step lookahead, min over neighbours n of g[n] + 1. A cell is queued
+// while the two differ. Keys carry the Manhattan distance from the start;
+// km accumulates how far the start has moved so that queued keys stay
+// valid lower bounds without being recomputed.
+class IncrementalPlanner {
+public:
+    explicit IncrementalPlanner(const Grid<unsigned char>& moves);
+
+    // Drops every estimate and plans toward `goal` from now on.
+    void setGoal(int goal);
+    int getGoal() const;
+    // Shortest path from `start` to the goal, repairing whatever updateCells
+    // invalidated. Cells from start to goal; empty when none exists.
+    MyVector<int> findPath(int start);
+    // Cells whose masks changed since the last findPath.
+    void updateCells(const MyVector<int>& changed);
+    // Cells expanded by the last findPath.
+    size_t getLastExpansions() const;
+
+private:
+    struct Key {
+        int primary;
+        int secondary;
+    };
+    struct Entry {
+        Key key;
+        int cell;
+    };
+
+    static const int unreachable;
+
+    const Grid<unsigned char>& moves;
+    int offset[4];
+    int goal;
+    int lastStart;
+    int km;
+    size_t lastExpansions;
+    Grid<int> g;
+    Grid<int> rhs;
+    // Position in heap, -1 when not queued.
+    Grid<int> heapIndex;
+    std::vector<Entry> heap;
+
+    static bool less(const Key& a, const Key& b);
+    Key keyOf(int cell, int start) const;
+    int heuristic(int from, int to) const;
+    int lookahead(int cell) const;
+    void updateVertex(int cell, int start);
+    void computeShortestPath(int start);
+
+    void push(int cell, const Key& key);
+    void remove(int cell);
+    void place(int index, const Entry& entry);
+    void siftUp(int index);
+    void siftDown(int index);
+};
+
+#endif // INCREMENTAL_PLANNER_H
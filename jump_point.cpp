@@ -0,0 +1,251 @@
+// jump_point.cpp
+#include "jump_point.h"
+#include <cstdlib>
+
+// Directions follow the solver's move masks: 0 = N, 1 = E, 2 = S, 3 = W.
+// Odd directions are horizontal.
+static bool isHorizontal(int dir) {
+    return (dir & 1) != 0;
+}
+
+JumpPointSearch::JumpPointSearch(const Grid<unsigned char>& moves)
+    : moves(moves), width(moves.width()), epoch(0), open(QueueKind::Bucket), goal(-1), pushed(0),
+      tableBuilt(false) {
+    offset[0] = -width;
+    offset[1] = 1;
+    offset[2] = width;
+    offset[3] = -1;
+}
+
+bool JumpPointSearch::canStep(int cell, int dir) const {
+    return (moves[cell] & (1 << dir)) != 0;
+}
+
+// Moving vertically from `from` to `to`, the sideways neighbour of `to` is
+// forced when the horizontal-first detour through from's side neighbour is
+// not available.
+bool JumpPointSearch::isForced(int from, int to, int dir, int side) const {
+    return canStep(to, side) && !(canStep(from, side) && canStep(from + offset[side], dir));
+}
+
+bool JumpPointSearch::hasForced(int from, int to, int dir) const {
+    return isForced(from, to, dir, 1) || isForced(from, to, dir, 3);
+}
+
+int JumpPointSearch::jump(int cell, int dir) const {
+    int at = cell;
+    while (canStep(at, dir)) {
+        int next = at + offset[dir];
+        if (next == goal) {
+            return next;
+        }
+        if (isHorizontal(dir)) {
+            // A horizontal run must stop wherever a vertical branch leads on
+            if (jump(next, 0) >= 0 || jump(next, 2) >= 0) {
+                return next;
+            }
+        } else if (hasForced(at, next, dir)) {
+            return next;
+        }
+        at = next;
+    }
+    return -1;
+}
+
+int JumpPointSearch::jumpWithTable(int cell, int dir) const {
+    int stored = table[static_cast<size_t>(cell) * 4 + dir];
+    int span = stored > 0 ? stored : -stored;
+    int x = cell % width;
+    int y = cell / width;
+    int goalX = goal % width;
+    int goalY = goal / width;
+    int step = (dir == 1 || dir == 2) ? 1 : -1;
+
+    if (isHorizontal(dir)) {
+        int ahead = (goalX - x) * step;
+        if (ahead >= 1 && ahead <= span && (stored <= 0 || ahead < stored)) {
+            // The goal's column is crossed before the next jump point: stop
+            // there if a clear vertical run leads straight to the goal.
+            int turn = cell + ahead * offset[dir];
+            int vertical = goalY < y ? 0 : 2;
+            int needed = std::abs(goalY - y);
+            int free = table[static_cast<size_t>(turn) * 4 + vertical];
+            if (needed == 0 || (free <= 0 && needed <= -free)) {
+                return turn;
+            }
+        }
+    } else if (goalX == x) {
+        int ahead = (goalY - y) * step;
+        if (ahead >= 1 && ahead <= span) {
+            return goal;
+        }
+    }
+    return stored > 0 ? cell + stored * offset[dir] : -1;
+}
+
+void JumpPointSearch::buildJumpTable() {
+    int height = moves.height();
+    table = MyVector<int>(moves.size() * 4, 0);
+    int* jumps = table.begin();
+
+    // Vertical runs first: N is filled top-down and S bottom-up so the
+    // neighbour ahead is always ready.
+    for (int pass = 0; pass < 2; ++pass) {
+        int dir = pass == 0 ? 0 : 2;
+        for (int row = 0; row < height; ++row) {
+            int y = pass == 0 ? row : height - 1 - row;
+            for (int x = 0; x < width; ++x) {
+                int cell = y * width + x;
+                int value = 0;
+                if (canStep(cell, dir)) {
+                    int next = cell + offset[dir];
+                    if (hasForced(cell, next, dir)) {
+                        value = 1;
+                    } else {
+                        int ahead = jumps[static_cast<size_t>(next) * 4 + dir];
+                        value = ahead > 0 ? ahead + 1 : ahead - 1;
+                    }
+                }
+                jumps[static_cast<size_t>(cell) * 4 + dir] = value;
+            }
+        }
+    }
+
+    // Horizontal runs stop at any cell with a vertical jump point ahead.
+    for (int pass = 0; pass < 2; ++pass) {
+        int dir = pass == 0 ? 1 : 3;
+        for (int y = 0; y < height; ++y) {
+            for (int column = 0; column < width; ++column) {
+                int x = pass == 0 ? width - 1 - column : column;
+                int cell = y * width + x;
+                int value = 0;
+                if (canStep(cell, dir)) {
+                    size_t next = static_cast<size_t>(cell + offset[dir]) * 4;
+                    if (jumps[next] > 0 || jumps[next + 2] > 0) {
+                        value = 1;
+                    } else {
+                        int ahead = jumps[next + dir];
+                        value = ahead > 0 ? ahead + 1 : ahead - 1;
+                    }
+                }
+                jumps[static_cast<size_t>(cell) * 4 + dir] = value;
+            }
+        }
+    }
+    tableBuilt = true;
+}
+
+void JumpPointSearch::clearJumpTable() {
+    table = MyVector<int>();
+    tableBuilt = false;
+}
+
+bool JumpPointSearch::hasJumpTable() const {
+    return tableBuilt;
+}
+
+size_t JumpPointSearch::getLastPushed() const {
+    return pushed;
+}
+
+int JumpPointSearch::heuristic(int cell) const {
+    return std::abs(cell % width - goal % width) + std::abs(cell / width - goal / width);
+}
+
+MyVector<std::pair<int, int>> JumpPointSearch::findPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    MyVector<std::pair<int, int>> path;
+    // Allocated on first use: a solver that never runs this mode pays nothing
+    if (reached.size() != moves.size()) {
+        reached = Grid<unsigned>(moves.width(), moves.height(), 0);
+        closed = Grid<unsigned>(moves.width(), moves.height(), 0);
+        g = Grid<int>(moves.width(), moves.height());
+        parent = Grid<int>(moves.width(), moves.height());
+        arrival = Grid<unsigned char>(moves.width(), moves.height());
+        epoch = 0;
+    }
+    ++epoch;
+    if (epoch == 0) {
+        reached.fill(0);
+        closed.fill(0);
+        epoch = 1;
+    }
+    open.clear();
+    pushed = 0;
+
+    int source = static_cast<int>(moves.index(start.first, start.second));
+    goal = static_cast<int>(moves.index(end.first, end.second));
+    g[source] = 0;
+    parent[source] = -1;
+    arrival[source] = 4;
+    reached[source] = epoch;
+    open.push(heuristic(source), source);
+    ++pushed;
+
+    while (!open.empty()) {
+        int key;
+        int cell = open.pop(key);
+        if (closed[cell] == epoch) {
+            continue;
+        }
+        closed[cell] = epoch;
+        if (cell == goal) {
+            break;
+        }
+
+        // Canonical successors: everything from the start, straight on plus
+        // both vertical turns after a horizontal jump, straight on plus any
+        // forced sideways turn after a vertical one.
+        int from = arrival[cell];
+        unsigned char directions = 0;
+        if (from == 4) {
+            directions = 0xF;
+        } else if (isHorizontal(from)) {
+            directions = static_cast<unsigned char>((1 << from) | (1 << 0) | (1 << 2));
+        } else {
+            directions = static_cast<unsigned char>(1 << from);
+            int behind = cell - offset[from];
+            for (int side = 1; side < 4; side += 2) {
+                if (isForced(behind, cell, from, side)) {
+                    directions |= 1 << side;
+                }
+            }
+        }
+
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!(directions & (1 << dir))) {
+                continue;
+            }
+            int next = tableBuilt ? jumpWithTable(cell, dir) : jump(cell, dir);
+            if (next < 0 || closed[next] == epoch) {
+                continue;
+            }
+            int length = std::abs(next % width - cell % width) + std::abs(next / width - cell / width);
+            int cost = g[cell] + length;
+            if (reached[next] != epoch || cost < g[next]) {
+                g[next] = cost;
+                parent[next] = cell;
+                arrival[next] = static_cast<unsigned char>(dir);
+                reached[next] = epoch;
+                open.push(cost + heuristic(next), next);
+                ++pushed;
+            }
+        }
+    }
+
+    if (closed[goal] != epoch) {
+        return path;
+    }
+
+    // Walk the jump points back to the start, filling in each straight run
+    for (int at = goal; at != -1; at = parent[at]) {
+        path.push_back({at % width, at / width});
+        if (parent[at] != -1) {
+            int back = offset[(arrival[at] + 2) & 3];
+            for (int cell = at + back; cell != parent[at]; cell += back) {
+                path.push_back({cell % width, cell / width});
+            }
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -0,0 +1,59 @@
+// jump_point.h
+#ifndef JUMP_POINT_H
+#define JUMP_POINT_H
+
+#include "frontier_queue.h"
+#include "grid.h"
+#include <utility>
+
+// Jump Point Search for 4-connected unit-cost grids (JPS4). Among the many
+// equally short routes through open space only the canonical one, which
+// takes horizontal steps before vertical ones, is explored. Straight runs
+// are skipped in one jump, so only cells where that route can turn get
+// queued.
+//
+// The grid must be uniform: a step between two open neighbours is always
+// allowed. buildJumpTable() precomputes every jump distance (JPS+), after
+// which a jump costs O(1) instead of a scan.
+class JumpPointSearch {
+public:
+    explicit JumpPointSearch(const Grid<unsigned char>& moves);
+
+    MyVector<std::pair<int, int>> findPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+
+    void buildJumpTable();
+    void clearJumpTable();
+    bool hasJumpTable() const;
+
+    // Jump points pushed to the open list by the last findPath call.
+    size_t getLastPushed() const;
+
+private:
+    const Grid<unsigned char>& moves;
+    int width;
+    int offset[4];
+
+    unsigned epoch;
+    Grid<unsigned> reached;
+    Grid<unsigned> closed;
+    Grid<int> g;
+    Grid<int> parent;
+    Grid<unsigned char> arrival; // direction of the jump that reached the cell; 4 = none
+    FrontierQueue open;
+    int goal;
+    size_t pushed;
+
+    // Four entries per cell, one per direction: k > 0 means the next jump
+    // point is k steps away; k <= 0 means -k free steps before a wall.
+    MyVector<int> table;
+    bool tableBuilt;
+
+    bool canStep(int cell, int dir) const;
+    bool isForced(int from, int to, int dir, int side) const;
+    bool hasForced(int from, int to, int dir) const;
+    int jump(int cell, int dir) const;
+    int jumpWithTable(int cell, int dir) const;
+    int heuristic(int cell) const;
+};
+
+#endif // JUMP_POINT_H
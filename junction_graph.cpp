@@ -0,0 +1,315 @@
+// junction_graph.cpp
+#include "junction_graph.h"
+#include "log.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+// Bits of arrival[node]
+static const unsigned char enteredAtB = 1; // reached through its edge's b end
+static const unsigned char fromStart = 2;  // that edge holds the start cell
+
+static int moveCount(unsigned char open) {
+    return (open & 1) + ((open >> 1) & 1) + ((open >> 2) & 1) + ((open >> 3) & 1);
+}
+
+JunctionGraph::JunctionGraph(const Grid<unsigned char>& moves)
+    : moves(moves), offset{-moves.width(), 1, moves.width(), -1}, built(false), stamp(0),
+      open(QueueKind::Bucket), pushed(0) {}
+
+void JunctionGraph::build() {
+    nodeOf = Grid<int>(moves.width(), moves.height(), -1);
+    edgeOf = Grid<int>(moves.width(), moves.height(), -1);
+    positionOf = Grid<int>(moves.width(), moves.height(), 0);
+    nodeCells.resize(0);
+    edges.resize(0);
+    cells.resize(0);
+
+    for (size_t cell = 0; cell < moves.size(); ++cell) {
+        if (moves[cell] != 0 && moveCount(moves[cell]) != 2) {
+            addNode(static_cast<int>(cell));
+        }
+    }
+    int junctions = static_cast<int>(nodeCells.size());
+    for (int node = 0; node < junctions; ++node) {
+        for (int dir = 0; dir < 4; ++dir) {
+            if (moves[nodeCells[node]] & (1 << dir)) {
+                trace(node, dir);
+            }
+        }
+    }
+    // Whatever corridor is still unassigned is a loop with no junction
+    for (size_t cell = 0; cell < moves.size(); ++cell) {
+        if (moveCount(moves[cell]) == 2 && nodeOf[cell] < 0 && edgeOf[cell] < 0) {
+            int node = addNode(static_cast<int>(cell));
+            for (int dir = 0; dir < 4; ++dir) {
+                if (moves[cell] & (1 << dir)) {
+                    trace(node, dir);
+                }
+            }
+        }
+    }
+
+    // Adjacency in one flat array. A self-loop never shortens a route, so
+    // it is left out; it only matters to endpoints lying on it.
+    int count = nodeCount();
+    linkStart = MyVector<int>(count + 1, 0);
+    for (const Edge& edge : edges) {
+        if (edge.a != edge.b) {
+            ++linkStart[edge.a + 1];
+            ++linkStart[edge.b + 1];
+        }
+    }
+    for (int node = 0; node < count; ++node) {
+        linkStart[node + 1] += linkStart[node];
+    }
+    links = MyVector<Link>(linkStart[count]);
+    MyVector<int> fill(linkStart);
+    for (int e = 0; e < edgeCount(); ++e) {
+        const Edge& edge = edges[e];
+        if (edge.a != edge.b) {
+            links[fill[edge.a]++] = {e, edge.b};
+            links[fill[edge.b]++] = {e, edge.a};
+        }
+    }
+
+    reached = MyVector<unsigned>(count, 0);
+    dist = MyVector<int>(count);
+    parentEdge = MyVector<int>(count);
+    arrival = MyVector<unsigned char>(count);
+    stamp = 0;
+    built = true;
+    LOG_DEBUG("Junction graph: " << count << " nodes, " << edgeCount() << " edges for " << moves.size() << " cells");
+}
+
+void JunctionGraph::clear() {
+    nodeOf = Grid<int>();
+    edgeOf = Grid<int>();
+    positionOf = Grid<int>();
+    nodeCells = MyVector<int>();
+    edges = MyVector<Edge>();
+    cells = MyVector<int>();
+    linkStart = MyVector<int>();
+    links = MyVector<Link>();
+    built = false;
+}
+
+bool JunctionGraph::isBuilt() const {
+    return built;
+}
+
+int JunctionGraph::nodeCount() const {
+    return static_cast<int>(nodeCells.size());
+}
+
+int JunctionGraph::edgeCount() const {
+    return static_cast<int>(edges.size());
+}
+
+size_t JunctionGraph::getLastPushed() const {
+    return pushed;
+}
+
+int JunctionGraph::addNode(int cell) {
+    nodeOf[cell] = nodeCount();
+    nodeCells.push_back(cell);
+    return nodeOf[cell];
+}
+
+void JunctionGraph::trace(int node, int dir) {
+    int prev = nodeCells[node];
+    int cur = prev + offset[dir];
+    if (nodeOf[cur] >= 0) {
+        // Two adjacent nodes: an edge with no interior, added from the
+        // lower id only
+        if (nodeOf[cur] > node) {
+            edges.push_back({node, nodeOf[cur], static_cast<int>(cells.size()), 0});
+        }
+        return;
+    }
+    if (edgeOf[cur] >= 0) {
+        return; // Traced already from its other end
+    }
+
+    Edge edge = {node, -1, static_cast<int>(cells.size()), 0};
+    int id = edgeCount();
+    while (nodeOf[cur] < 0) {
+        edgeOf[cur] = id;
+        positionOf[cur] = edge.count++;
+        cells.push_back(cur);
+        unsigned char open = moves[cur];
+        int next = -1;
+        for (int d = 0; d < 4; ++d) {
+            if ((open & (1 << d)) && cur + offset[d] != prev) {
+                next = cur + offset[d];
+                break;
+            }
+        }
+        prev = cur;
+        cur = next;
+    }
+    edge.b = nodeOf[cur];
+    edges.push_back(edge);
+}
+
+void JunctionGraph::relax(int node, int distance, int edge, unsigned char how) {
+    if (reached[node] == stamp && dist[node] <= distance) {
+        return;
+    }
+    reached[node] = stamp;
+    dist[node] = distance;
+    parentEdge[node] = edge;
+    arrival[node] = how;
+    open.push(distance, node);
+    ++pushed;
+}
+
+MyVector<std::pair<int, int>> JunctionGraph::findPath(const std::pair<int, int>& start,
+                                                      const std::pair<int, int>& end) {
+    MyVector<std::pair<int, int>> path;
+    if (!built) {
+        build();
+    }
+    int startCell = static_cast<int>(moves.index(start.first, start.second));
+    int endCell = static_cast<int>(moves.index(end.first, end.second));
+    pushed = 0;
+    if (startCell == endCell) {
+        path.push_back(start);
+        return path;
+    }
+    if (moves[startCell] == 0 || moves[endCell] == 0) {
+        return path;
+    }
+    if (++stamp == 0) {
+        std::fill(reached.begin(), reached.end(), 0u);
+        stamp = 1;
+    }
+    open.clear();
+
+    // The end is reached from at most two nodes: itself, or both ends of
+    // the corridor it lies in.
+    int endNode = nodeOf[endCell];
+    int endEdge = -1;
+    int endPosition = 0;
+    int endA = endNode;
+    int endB = -1;
+    int costA = 0;
+    int costB = 0;
+    if (endNode < 0) {
+        endEdge = edgeOf[endCell];
+        endPosition = positionOf[endCell];
+        endA = edges[endEdge].a;
+        endB = edges[endEdge].b;
+        costA = endPosition + 1;
+        costB = edges[endEdge].count - endPosition;
+    }
+
+    int best = std::numeric_limits<int>::max();
+    int bestNode = -1;
+    bool bestAtB = false;
+    int startEdge = -1;
+    int startPosition = 0;
+    if (nodeOf[startCell] >= 0) {
+        relax(nodeOf[startCell], 0, -1, 0);
+    } else {
+        startEdge = edgeOf[startCell];
+        startPosition = positionOf[startCell];
+        const Edge& edge = edges[startEdge];
+        if (startEdge == endEdge) {
+            best = std::abs(startPosition - endPosition); // Straight along the corridor
+        }
+        relax(edge.a, startPosition + 1, startEdge, fromStart);
+        relax(edge.b, edge.count - startPosition, startEdge, fromStart | enteredAtB);
+    }
+
+    while (!open.empty()) {
+        int key;
+        int node = open.pop(key);
+        if (key >= best) {
+            break;
+        }
+        if (key > dist[node]) {
+            continue; // Stale entry left behind by an earlier improvement
+        }
+        if (node == endA && key + costA < best) {
+            best = key + costA;
+            bestNode = node;
+            bestAtB = false;
+        }
+        if (node == endB && key + costB < best) {
+            best = key + costB;
+            bestNode = node;
+            bestAtB = true;
+        }
+        for (int i = linkStart[node]; i < linkStart[node + 1]; ++i) {
+            const Link& link = links.begin()[i];
+            const Edge& edge = edges.begin()[link.edge];
+            relax(link.to, key + edge.count + 1, link.edge, edge.a == node ? enteredAtB : 0);
+        }
+    }
+    LOG_DEBUG("Junction graph search pushed " << pushed << " nodes");
+
+    if (best == std::numeric_limits<int>::max()) {
+        return path;
+    }
+    path.reserve(best + 1);
+    if (bestNode < 0) {
+        int step = endPosition > startPosition ? 1 : -1;
+        path.push_back(start);
+        appendCells(path, startEdge, startPosition + step, step, best);
+        return path;
+    }
+
+    // Nodes from the first one after the start up to bestNode
+    MyVector<int> chain;
+    for (int node = bestNode;; ) {
+        chain.push_back(node);
+        if (parentEdge[node] < 0 || (arrival[node] & fromStart)) {
+            break;
+        }
+        const Edge& edge = edges[parentEdge[node]];
+        node = (arrival[node] & enteredAtB) ? edge.a : edge.b;
+    }
+    std::reverse(chain.begin(), chain.end());
+
+    path.push_back(start);
+    for (size_t i = 0; i < chain.size(); ++i) {
+        int node = chain[i];
+        int e = parentEdge[node];
+        bool atB = (arrival[node] & enteredAtB) != 0;
+        if (e < 0) {
+            continue; // The start itself
+        }
+        if (arrival[node] & fromStart) {
+            if (atB) {
+                appendCells(path, e, startPosition + 1, 1, edges[e].count - 1 - startPosition);
+            } else {
+                appendCells(path, e, startPosition - 1, -1, startPosition);
+            }
+        } else if (atB) {
+            appendCells(path, e, 0, 1, edges[e].count);
+        } else {
+            appendCells(path, e, edges[e].count - 1, -1, edges[e].count);
+        }
+        path.push_back(at(nodeCells[node]));
+    }
+    if (endNode < 0) {
+        if (bestAtB) {
+            appendCells(path, endEdge, edges[endEdge].count - 1, -1, edges[endEdge].count - endPosition);
+        } else {
+            appendCells(path, endEdge, 0, 1, endPosition + 1);
+        }
+    }
+    return path;
+}
+
+void JunctionGraph::appendCells(MyVector<std::pair<int, int>>& path, int edge, int from, int step, int n) const {
+    const int* interior = cells.begin() + edges.begin()[edge].first;
+    for (int i = 0; i < n; ++i) {
+        path.push_back(at(interior[from + i * step]));
+    }
+}
+
+std::pair<int, int> JunctionGraph::at(int cell) const {
+    return {moves.xOf(cell), moves.yOf(cell)};
+}
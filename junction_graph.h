@@ -0,0 +1,82 @@
+// junction_graph.h
+#ifndef JUNCTION_GRAPH_H
+#define JUNCTION_GRAPH_H
+
+#include "frontier_queue.h"
+#include "grid.h"
+#include <utility>
+
+// Corridor-compressed search graph. Open cells with exactly two moves are
+// corridor cells; every other open cell (junction, dead end, isolated cell)
+// is a node. Each maximal corridor becomes one weighted edge between the
+// nodes at its ends, so Dijkstra only queues nodes, and corridor cells are
+// written out only for the final path.
+//
+// A query endpoint inside a corridor is attached to both ends of its edge.
+// A corridor that closes on itself with no junction gets one of its cells
+// promoted to a node.
+class JunctionGraph {
+public:
+    explicit JunctionGraph(const Grid<unsigned char>& moves);
+
+    void build();
+    void clear();
+    bool isBuilt() const;
+
+    MyVector<std::pair<int, int>> findPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+
+    int nodeCount() const;
+    int edgeCount() const;
+    // Nodes pushed to the open list by the last findPath call.
+    size_t getLastPushed() const;
+
+private:
+    // Interior cells from a's side to b's side are
+    // cells[first .. first + count).
+    struct Edge {
+        int a;
+        int b;
+        int first;
+        int count;
+    };
+    struct Link {
+        int edge;
+        int to;
+    };
+
+    const Grid<unsigned char>& moves;
+    int offset[4];
+    bool built;
+
+    // For a node cell nodeOf is its node id; for a corridor cell nodeOf is
+    // -1 and edgeOf/positionOf place it inside an edge. Other cells: -1.
+    Grid<int> nodeOf;
+    Grid<int> edgeOf;
+    Grid<int> positionOf;
+    MyVector<int> nodeCells;
+    MyVector<Edge> edges;
+    MyVector<int> cells;
+    // Links of node n are links[linkStart[n] .. linkStart[n + 1]).
+    MyVector<int> linkStart;
+    MyVector<Link> links;
+
+    // Per-query node labels, live when stamp matches.
+    unsigned stamp;
+    MyVector<unsigned> reached;
+    MyVector<int> dist;
+    MyVector<int> parentEdge; // -1 for the start's own node
+    // How each node was entered: enteredAtB and/or fromStart.
+    MyVector<unsigned char> arrival;
+    FrontierQueue open;
+    size_t pushed;
+
+    void trace(int node, int dir);
+    int addNode(int cell);
+    void relax(int node, int distance, int edge, unsigned char how);
+    // Appends `n` interior cells of `edge`, from position `from` in steps
+    // of `step` (+1 toward b, -1 toward a).
+    void appendCells(MyVector<std::pair<int, int>>& path, int edge, int from, int step, int n) const;
+    std::pair<int, int> at(int cell) const;
+};
+
+#endif // JUNCTION_GRAPH_H
@@ -0,0 +1,225 @@
+// landmarks.cpp
+#include "landmarks.h"
+#include "distance_field.h"
+#include "log.h"
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+static const char landmarkMagic[4] = {'D', 'K', 'L', 'M'};
+static const uint32_t landmarkVersion = 1;
+
+LandmarkTable::LandmarkTable() : width(0), height(0), mazeChecksum(0), count(0) {}
+
+void LandmarkTable::build(const Grid<unsigned char>& moves, int count, size_t memoryBudget) {
+    width = moves.width();
+    height = moves.height();
+    mazeChecksum = checksum(moves);
+    this->count = 0;
+    landmarks = MyVector<int>();
+    distances = MyVector<int>();
+
+    size_t cells = moves.size();
+    if (memoryBudget > 0 && cells > 0) {
+        size_t fit = memoryBudget / (cells * sizeof(int));
+        if (fit < static_cast<size_t>(count)) {
+            count = static_cast<int>(fit);
+        }
+    }
+
+    int seed = -1;
+    for (size_t cell = 0; cell < cells && seed < 0; ++cell) {
+        if (moves[cell] != 0) {
+            seed = static_cast<int>(cell);
+        }
+    }
+    if (count <= 0 || seed < 0) {
+        return;
+    }
+
+    // Farthest-point selection: each new landmark is the open cell farthest
+    // from every landmark chosen so far. Cells none of them reach count as
+    // infinitely far, so every connected region gets a landmark in turn.
+    // The arbitrary seed cell only serves to place the first landmark.
+    Grid<int> field;
+    MyVector<int> nearest(cells, std::numeric_limits<int>::max());
+    computeDistanceField(moves, seed, field);
+    for (size_t cell = 0; cell < cells; ++cell) {
+        if (field[cell] >= 0) {
+            nearest[cell] = field[cell];
+        }
+    }
+
+    MyVector<MyVector<int>> fields;
+    for (int k = 0; k < count; ++k) {
+        int best = -1;
+        for (size_t cell = 0; cell < cells; ++cell) {
+            if (moves[cell] != 0 && (best < 0 || nearest[cell] > nearest[best])) {
+                best = static_cast<int>(cell);
+            }
+        }
+        if (best < 0 || nearest[best] == 0) {
+            break;
+        }
+        computeDistanceField(moves, best, field);
+        MyVector<int> column(cells);
+        for (size_t cell = 0; cell < cells; ++cell) {
+            column[cell] = field[cell];
+            if (field[cell] >= 0 && field[cell] < nearest[cell]) {
+                nearest[cell] = field[cell];
+            }
+        }
+        landmarks.push_back(best);
+        fields.push_back(std::move(column));
+    }
+
+    this->count = static_cast<int>(landmarks.size());
+    distances = MyVector<int>(cells * this->count);
+    for (size_t cell = 0; cell < cells; ++cell) {
+        for (int k = 0; k < this->count; ++k) {
+            distances[cell * this->count + k] = fields[k][cell];
+        }
+    }
+    LOG_DEBUG("Built " << this->count << " landmarks, " << memoryUsage() << " bytes");
+}
+
+bool LandmarkTable::empty() const {
+    return count == 0;
+}
+
+int LandmarkTable::landmarkCount() const {
+    return count;
+}
+
+std::pair<int, int> LandmarkTable::getLandmark(int i) const {
+    return {landmarks[i] % width, landmarks[i] / width};
+}
+
+size_t LandmarkTable::memoryUsage() const {
+    return distances.size() * sizeof(int) + landmarks.size() * sizeof(int);
+}
+
+// Bytes left to read from in, or -1 when the stream cannot seek.
+static std::streamoff remainingBytes(std::istream& in) {
+    std::streampos here = in.tellg();
+    if (here == std::streampos(-1)) {
+        return -1;
+    }
+    in.seekg(0, std::ios::end);
+    std::streampos end = in.tellg();
+    in.clear();
+    in.seekg(here);
+    if (end == std::streampos(-1) || !in) {
+        in.clear();
+        return -1;
+    }
+    return end - here;
+}
+
+bool LandmarkTable::save(std::ostream& out) const {
+    int32_t header[4] = {width, height, static_cast<int32_t>(mazeChecksum), count};
+    out.write(landmarkMagic, sizeof(landmarkMagic));
+    out.write(reinterpret_cast<const char*>(&landmarkVersion), sizeof(landmarkVersion));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(landmarks.begin()), landmarks.size() * sizeof(int));
+    out.write(reinterpret_cast<const char*>(distances.begin()), distances.size() * sizeof(int));
+    return static_cast<bool>(out);
+}
+
+bool LandmarkTable::load(std::istream& in, const Grid<unsigned char>& moves) {
+    char magic[4];
+    uint32_t version = 0;
+    int32_t header[4];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || std::equal(magic, magic + 4, landmarkMagic) == false || version != landmarkVersion) {
+        LOG_ERROR("Error: Not a landmark table");
+        return false;
+    }
+    if (header[0] != moves.width() || header[1] != moves.height() ||
+        static_cast<uint32_t>(header[2]) != checksum(moves) || header[3] < 0) {
+        LOG_ERROR("Error: Landmark table was built for a different maze");
+        return false;
+    }
+
+    // Landmarks are distinct open cells, so a larger count is corrupt. The
+    // stream must also still hold every table before anything is allocated.
+    size_t cells = moves.size();
+    size_t openCells = 0;
+    for (size_t cell = 0; cell < cells; ++cell) {
+        openCells += moves[cell] != 0;
+    }
+    size_t landmarkCount = static_cast<size_t>(header[3]);
+    if (landmarkCount > openCells) {
+        LOG_ERROR("Error: Landmark table lists " << landmarkCount << " landmarks for " << openCells << " open cells");
+        return false;
+    }
+    std::streamoff needed = static_cast<std::streamoff>((landmarkCount + cells * landmarkCount) * sizeof(int));
+    std::streamoff available = remainingBytes(in);
+    if (available >= 0 && available < needed) {
+        LOG_ERROR("Error: Landmark table is truncated");
+        return false;
+    }
+
+    MyVector<int> loadedLandmarks(landmarkCount);
+    in.read(reinterpret_cast<char*>(loadedLandmarks.begin()), landmarkCount * sizeof(int));
+    if (!in) {
+        LOG_ERROR("Error: Landmark table is truncated");
+        return false;
+    }
+    for (size_t i = 0; i < landmarkCount; ++i) {
+        int cell = loadedLandmarks[i];
+        if (cell < 0 || static_cast<size_t>(cell) >= cells || moves[cell] == 0) {
+            LOG_ERROR("Error: Landmark " << i << " is not an open cell");
+            return false;
+        }
+    }
+
+    // A stream that cannot report its length is read in chunks, so a bad
+    // header runs out of data long before it runs out of memory.
+    MyVector<int> loadedDistances;
+    size_t total = cells * landmarkCount;
+    if (available >= 0) {
+        loadedDistances.resize(total);
+        in.read(reinterpret_cast<char*>(loadedDistances.begin()), total * sizeof(int));
+    } else {
+        const size_t chunk = size_t(1) << 16;
+        for (size_t done = 0; done < total && in; done += chunk) {
+            size_t part = std::min(chunk, total - done);
+            if (done + part > loadedDistances.capacity()) {
+                loadedDistances.reserve(std::min(total, std::max(done + part, 2 * loadedDistances.capacity())));
+            }
+            loadedDistances.resize(done + part);
+            in.read(reinterpret_cast<char*>(loadedDistances.begin() + done), part * sizeof(int));
+        }
+    }
+    if (!in) {
+        LOG_ERROR("Error: Landmark table is truncated");
+        return false;
+    }
+
+    width = header[0];
+    height = header[1];
+    mazeChecksum = static_cast<uint32_t>(header[2]);
+    count = header[3];
+    landmarks = std::move(loadedLandmarks);
+    distances = std::move(loadedDistances);
+    return true;
+}
+
+uint32_t LandmarkTable::checksum(const Grid<unsigned char>& moves) {
+    // FNV-1a over the dimensions and direction masks
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](uint32_t byte) {
+        hash ^= byte;
+        hash *= 16777619u;
+    };
+    mix(static_cast<uint32_t>(moves.width()));
+    mix(static_cast<uint32_t>(moves.height()));
+    for (size_t cell = 0; cell < moves.size(); ++cell) {
+        mix(moves[cell]);
+    }
+    return hash;
+}
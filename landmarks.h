@@ -0,0 +1,78 @@
+// landmarks.h
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "grid.h"
+#include <cstdint>
+#include <cstdlib>
+#include <iosfwd>
+#include <utility>
+
+// ALT preprocessing: exact distance fields from a few landmark cells. For
+// any landmark L, |d(L, t) - d(L, v)| never exceeds d(v, t), so the maximum
+// over all landmarks is an admissible, consistent A* heuristic that follows
+// the maze's walls instead of ignoring them like Manhattan distance.
+class LandmarkTable {
+public:
+    LandmarkTable();
+
+    // Picks up to count landmarks by farthest-point selection over the open
+    // cells of moves. A non-zero memoryBudget (bytes) caps how many distance
+    // tables are kept.
+    void build(const Grid<unsigned char>& moves, int count, size_t memoryBudget = 0);
+
+    bool empty() const;
+    int landmarkCount() const;
+    std::pair<int, int> getLandmark(int i) const;
+    size_t memoryUsage() const;
+
+    // Lower bound on the distance between two flat cell indices.
+    int lowerBound(int cell, int target) const;
+
+    // Binary format tied to the maze through a checksum of its direction
+    // masks; load() rejects tables built for a different maze.
+    bool save(std::ostream& out) const;
+    bool load(std::istream& in, const Grid<unsigned char>& moves);
+
+    static uint32_t checksum(const Grid<unsigned char>& moves);
+
+private:
+    int width, height;
+    uint32_t mazeChecksum;
+    int count;
+    MyVector<int> landmarks;
+    // count distances per cell, stored cell-major so one heuristic
+    // evaluation reads a single contiguous run. -1 marks unreachable.
+    MyVector<int> distances;
+};
+
+inline int LandmarkTable::lowerBound(int cell, int target) const {
+    const int* from = distances.begin() + static_cast<size_t>(cell) * count;
+    const int* to = distances.begin() + static_cast<size_t>(target) * count;
+    int best = 0;
+    for (int i = 0; i < count; ++i) {
+        if (from[i] < 0 || to[i] < 0) {
+            continue;
+        }
+        int bound = std::abs(from[i] - to[i]);
+        if (bound > best) {
+            best = bound;
+        }
+    }
+    return best;
+}
+
+// A* heuristic backed by a LandmarkTable; also takes the Manhattan bound,
+// which can be the tighter of the two in open areas.
+struct AltHeuristic {
+    const LandmarkTable& table;
+    int width;
+
+    int operator()(int x, int y, int goalX, int goalY) const {
+        int alt = table.lowerBound(y * width + x, goalY * width + goalX);
+        int manhattan = std::abs(x - goalX) + std::abs(y - goalY);
+        return alt > manhattan ? alt : manhattan;
+    }
+};
+
+#endif // LANDMARKS_H
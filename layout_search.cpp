@@ -0,0 +1,57 @@
+// layout_search.cpp
+#include "layout_search.h"
+#include "log.h"
+
+LayoutSearch::LayoutSearch(const Grid<unsigned char>& moves, CellLayout layout) : moves(moves), layout(layout) {
+    rebuild();
+}
+
+void LayoutSearch::rebuild() {
+    switch (layout) {
+    case CellLayout::RowMajor:
+        rowMajor.build(moves);
+        break;
+    case CellLayout::Tiled:
+        tiled.build(moves);
+        break;
+    case CellLayout::Morton:
+        morton.build(moves);
+        break;
+    }
+}
+
+MyVector<std::pair<int, int>> LayoutSearch::findPath(const std::pair<int, int>& start,
+                                                     const std::pair<int, int>& end) {
+    if (!moves.inBounds(start.first, start.second) || !moves.inBounds(end.first, end.second)) {
+        LOG_ERROR("Error: Start or end point is out of bounds");
+        return MyVector<std::pair<int, int>>();
+    }
+    if (moves(start.first, start.second) == 0 || moves(end.first, end.second) == 0) {
+        LOG_ERROR("Error: Start (" << start.first << "," << start.second << ") or end (" << end.first << ","
+                  << end.second << ") is not open");
+        return MyVector<std::pair<int, int>>();
+    }
+    switch (layout) {
+    case CellLayout::RowMajor:
+        return rowMajor.findPath(start, end);
+    case CellLayout::Tiled:
+        return tiled.findPath(start, end);
+    default:
+        return morton.findPath(start, end);
+    }
+}
+
+CellLayout LayoutSearch::getLayout() const {
+    return layout;
+}
+
+size_t LayoutSearch::memoryUsage() const {
+    switch (layout) {
+    case CellLayout::RowMajor:
+        return rowMajor.memoryUsage();
+    case CellLayout::Tiled:
+        return tiled.memoryUsage();
+    default:
+        return morton.memoryUsage();
+    }
+}
@@ -0,0 +1,127 @@
+// layout_search.h
+#ifndef LAYOUT_SEARCH_H
+#define LAYOUT_SEARCH_H
+
+#include "cell_layout.h"
+#include "grid.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+// Breadth-first search over a copy of the move masks stored in Layout's
+// order. Layout is a template parameter so index and step arithmetic are
+// inlined into the loop; nothing is decided per cell at run time.
+template <typename Layout>
+class LayoutEngine {
+public:
+    LayoutEngine();
+
+    // Copies `moves` into layout order; call again after they change.
+    void build(const Grid<unsigned char>& moves);
+    MyVector<std::pair<int, int>> findPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+    size_t memoryUsage() const;
+
+private:
+    static const unsigned char moveMask = 15;
+    static const int parentShift = 4;
+
+    Layout layout;
+    // Bits 0-3: open moves. Bits 4-5: direction back to the parent, valid
+    // while the cell's stamp is current.
+    MyVector<unsigned char> cells;
+    MyVector<unsigned> stamps;
+    unsigned stamp;
+    MyVector<size_t> queue;
+};
+
+// Solver facade that picks the layout at construction. It is a standalone
+// engine over a maze's move masks: dekstra keeps its row-major grids and
+// does not route queries through it. bench_layouts compares the layouts.
+class LayoutSearch {
+public:
+    LayoutSearch(const Grid<unsigned char>& moves, CellLayout layout = CellLayout::Tiled);
+
+    // Re-reads the move masks after the maze was edited.
+    void rebuild();
+    // Only masks are known here, so a cell without moves counts as a wall:
+    // such an endpoint is rejected with an error, as is one out of bounds.
+    MyVector<std::pair<int, int>> findPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+
+    CellLayout getLayout() const;
+    size_t memoryUsage() const;
+
+private:
+    const Grid<unsigned char>& moves;
+    CellLayout layout;
+    // Only the engine for `layout` is built; the others stay empty.
+    LayoutEngine<RowMajorLayout> rowMajor;
+    LayoutEngine<TiledLayout> tiled;
+    LayoutEngine<MortonLayout> morton;
+};
+
+template <typename Layout>
+LayoutEngine<Layout>::LayoutEngine() : stamp(0) {}
+
+template <typename Layout>
+void LayoutEngine<Layout>::build(const Grid<unsigned char>& moves) {
+    layout = Layout(moves.width(), moves.height());
+    cells = MyVector<unsigned char>(layout.size(), 0);
+    stamps = MyVector<unsigned>(layout.size(), 0);
+    stamp = 0;
+    unsigned char* out = cells.begin();
+    for (int y = 0; y < moves.height(); ++y) {
+        for (int x = 0; x < moves.width(); ++x) {
+            out[layout.index(x, y)] = moves(x, y);
+        }
+    }
+}
+
+template <typename Layout>
+MyVector<std::pair<int, int>> LayoutEngine<Layout>::findPath(const std::pair<int, int>& start,
+                                                             const std::pair<int, int>& end) {
+    MyVector<std::pair<int, int>> path;
+    if (++stamp == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0u);
+        stamp = 1;
+    }
+    unsigned char* open = cells.begin();
+    unsigned* seen = stamps.begin();
+    size_t source = layout.index(start.first, start.second);
+    size_t target = layout.index(end.first, end.second);
+    seen[source] = stamp;
+    queue.resize(0);
+    queue.push_back(source);
+
+    for (size_t head = 0; head < queue.size() && seen[target] != stamp; ++head) {
+        size_t cell = queue.begin()[head];
+        unsigned char mask = open[cell] & moveMask;
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!(mask & (1 << dir))) {
+                continue;
+            }
+            size_t next = layout.step(cell, dir);
+            if (seen[next] != stamp) {
+                seen[next] = stamp;
+                open[next] = static_cast<unsigned char>((open[next] & moveMask) | (((dir + 2) & 3) << parentShift));
+                queue.push_back(next);
+            }
+        }
+    }
+    if (seen[target] != stamp) {
+        return path;
+    }
+
+    for (size_t at = target; at != source; at = layout.step(at, open[at] >> parentShift)) {
+        path.push_back({layout.xOf(at), layout.yOf(at)});
+    }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+template <typename Layout>
+size_t LayoutEngine<Layout>::memoryUsage() const {
+    return cells.size() + stamps.size() * sizeof(unsigned) + queue.capacity() * sizeof(size_t);
+}
+
+#endif // LAYOUT_SEARCH_H
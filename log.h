@@ -0,0 +1,82 @@
+// log.h
+#ifndef LOG_H
+#define LOG_H
+
+#include <iostream>
+
+// Log levels, from least to most verbose.
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_DEBUG 3
+#define LOG_LEVEL_TRACE 4
+
+// Highest level compiled into the binary. Statements above it expand to an
+// empty statement, so their arguments are never formatted. Production builds
+// pass -DLOG_COMPILE_LEVEL=LOG_LEVEL_ERROR (or LOG_LEVEL_NONE).
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+namespace logging {
+
+// Runtime threshold; only levels <= this value are written.
+inline int& levelRef() {
+    static int level = LOG_LEVEL_INFO;
+    return level;
+}
+
+inline int level() {
+    return levelRef();
+}
+
+inline void setLevel(int level) {
+    levelRef() = level;
+}
+
+inline bool enabled(int level) {
+    return level <= levelRef();
+}
+
+} // namespace logging
+
+// Lines end in '\n' rather than std::endl; errors go to std::cerr, which is
+// unbuffered anyway.
+#define LOG_WRITE(level, stream, expr) \
+    do { \
+        if (logging::enabled(level)) { \
+            stream << expr << '\n'; \
+        } \
+    } while (0)
+
+#define LOG_DISABLED(expr) do {} while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(expr) LOG_WRITE(LOG_LEVEL_ERROR, std::cerr, expr)
+#else
+#define LOG_ERROR(expr) LOG_DISABLED(expr)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(expr) LOG_WRITE(LOG_LEVEL_INFO, std::cout, expr)
+#else
+#define LOG_INFO(expr) LOG_DISABLED(expr)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(expr) LOG_WRITE(LOG_LEVEL_DEBUG, std::cout, expr)
+#else
+#define LOG_DEBUG(expr) LOG_DISABLED(expr)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE(expr) LOG_WRITE(LOG_LEVEL_TRACE, std::cout, expr)
+#else
+#define LOG_TRACE(expr) LOG_DISABLED(expr)
+#endif
+
+#endif // LOG_H
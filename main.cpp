@@ -1,7 +1,8 @@
 #include "raylib.h"
 #include "maze.h"
 #include "dekstra.h"
-#include <iostream>
+#include "path_cache.h"
+#include "log.h"
 const int CELL_SIZE = 30;
 const int WIDTH = 30;
 const int HEIGHT = 30;
@@ -19,34 +20,36 @@ int main() {
     auto end = generator.getEndPoint();
 
     // Debug output for start and end points
-    std::cout << "Start point: (" << start.first << "," << start.second << ")" << std::endl;
-    std::cout << "End point: (" << end.first << "," << end.second << ")" << std::endl;
+    LOG_INFO("Start point: (" << start.first << "," << start.second << ")");
+    LOG_INFO("End point: (" << end.first << "," << end.second << ")");
 
     // Validate start and end points
     if (start.first < 0 || start.first >= WIDTH || start.second < 0 || start.second >= HEIGHT) {
-        std::cerr << "Error: Invalid start point coordinates" << std::endl;
+        LOG_ERROR("Error: Invalid start point coordinates");
         return 1;
     }
 
     if (end.first < 0 || end.first >= WIDTH || end.second < 0 || end.second >= HEIGHT) {
-        std::cerr << "Error: Invalid end point coordinates" << std::endl;
+        LOG_ERROR("Error: Invalid end point coordinates");
         return 1;
     }
 
     // Debug output for maze cells at start and end positions
-    std::cout << "Maze at start: " << maze[start.second][start.first] << std::endl;
-    std::cout << "Maze at end: " << maze[end.second][end.first] << std::endl;
+    LOG_DEBUG("Maze at start: " << maze(start.first, start.second));
+    LOG_DEBUG("Maze at end: " << maze(end.first, end.second));
 
     std::pair<int, int> currentPos = start; // Current player position
 
     dekstra solver(maze);
+    solver.setGoal(end);
+    PathCache pathCache(solver);
     auto path = solver.findShortestPath(start, end);
     
     // Check if a valid path was found
     if (path.size() == 0) {
-        std::cerr << "Error: No valid path found between start and end points" << std::endl;
+        LOG_ERROR("Error: No valid path found between start and end points");
     } else {
-        std::cout << "Valid path found with " << path.size() << " steps" << std::endl;
+        LOG_INFO("Valid path found with " << path.size() << " steps");
     }
     bool showSteps = false;
     bool isFinished = false;
@@ -65,28 +68,26 @@ int main() {
         if (IsKeyPressed(KEY_SPACE)) {
             // Validate end point before finding path
             if (end.first < 0 || end.first >= WIDTH || end.second < 0 || end.second >= HEIGHT) {
-                std::cout << "Cannot move: end point is invalid" << std::endl;
+                LOG_INFO("Cannot move: end point is invalid");
             } else {
-                // Find path from current position to end
-                std::cout << "Finding path from (" << currentPos.first << "," << currentPos.second 
-                          << ") to (" << end.first << "," << end.second << ")" << std::endl;
-                
-                auto path = solver.findShortestPath(currentPos, end);
+                // The goal never changes, so follow the distance field built
+                // from it instead of re-solving from the current position
+                int remaining = solver.distanceToGoal(currentPos);
                 
                 // Move to next position if there is a valid path
-                if (path.size() > 1) { // Ensure path has at least current position and next position
-                    currentPos = path[1]; // Move to the first step (index 1, since index 0 is current position)
+                if (remaining > 0) {
+                    currentPos = solver.nextStepToGoal(currentPos);
                     
                     // Print debug info
-                    std::cout << "Moving to: (" << currentPos.first << "," << currentPos.second 
-                              << "), Path size: " << path.size() << std::endl;
+                    LOG_DEBUG("Moving to: (" << currentPos.first << "," << currentPos.second 
+                              << "), Steps left: " << remaining - 1);
                     
                     // Check if reached the end
                     if (currentPos.first == end.first && currentPos.second == end.second) {
-                        std::cout << "Reached the end!" << std::endl;
+                        LOG_INFO("Reached the end!");
                     }
                 } else {
-                    std::cout << "No valid path found or already at destination." << std::endl;
+                    LOG_INFO("No valid path found or already at destination.");
                 }
             }
             
@@ -96,9 +97,7 @@ int main() {
                 solver.findShortestPath(currentPos, end);
                 isFinished = false;
             } else {
-                // Force recalculation of path for visualization
-                solver.reset();
-                solver.findShortestPath(currentPos, end);
+                // The drawn path comes from the cache, nothing to re-solve
                 isFinished = true;
             }
         }
@@ -115,7 +114,7 @@ int main() {
             for (int x = 0; x < WIDTH; ++x) {
                 Color cellColor;
                 // Properly visualize different cell types
-                switch (maze[y][x]) {
+                switch (maze(x, y)) {
                     case '+': // Wall
                         cellColor = BLACK;
                         break;
@@ -138,10 +137,9 @@ int main() {
 
         // Draw visited nodes from start
         if (showSteps) {
-            auto visited = solver.getVisited();
             for (int y = 0; y < HEIGHT; ++y) {
                 for (int x = 0; x < WIDTH; ++x) {
-                    if (visited[y][x]) {
+                    if (solver.isVisited(x, y)) {
                         DrawRectangle(
                             x * CELL_SIZE + CELL_SIZE/4,
                             y * CELL_SIZE + CELL_SIZE/4,
@@ -207,7 +205,7 @@ int main() {
         if ((isFinished || !showSteps) && 
             end.first >= 0 && end.first < WIDTH && end.second >= 0 && end.second < HEIGHT) {
             // Use current position instead of start for path
-            auto path = solver.findShortestPath(currentPos, end);
+            const auto& path = pathCache.findShortestPath(currentPos, end);
             // Draw path as a connected line
             if (path.size() > 1) {
                 for (size_t i = 0; i < path.size() - 1; i++) {
@@ -4,27 +4,27 @@
 #include <ctime>
 #include <stack>
 #include <utility>
-#include <iostream>
+#include "log.h"
 MazeGenerator::MazeGenerator(int width, int height)
-    : width(width), height(height), maze(height, MyVector<char>(width, '+')),
+    : width(width), height(height), maze(width, height, '+'),
       start({-1, -1}), end({-1, -1}) {
     std::srand(std::time(0));
 }
 
 void MazeGenerator::generate() {
-    std::cout << "Generating maze of size " << width << "x" << height << std::endl;
+    LOG_INFO("Generating maze of size " << width << "x" << height);
     
     // Initialize maze with walls
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
-            maze[y][x] = '+';
+            maze(x, y) = '+';
         }
     }
     
     // Start carving from a random point
     int startX = 1 + std::rand() % (width - 2);
     int startY = 1 + std::rand() % (height - 2);
-    std::cout << "Starting maze generation from (" << startX << "," << startY << ")" << std::endl;
+    LOG_DEBUG("Starting maze generation from (" << startX << "," << startY << ")");
     
     carvePath(startX, startY);
     setStartEndPoints();
@@ -33,16 +33,16 @@ void MazeGenerator::generate() {
     int pathCount = 0;
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
-            if (maze[y][x] == '-') {
+            if (maze(x, y) == '-') {
                 pathCount++;
             }
         }
     }
-    std::cout << "Maze generation complete. Path cells: " << pathCount << std::endl;
+    LOG_INFO("Maze generation complete. Path cells: " << pathCount);
 }
 
 void MazeGenerator::carvePath(int x, int y) {
-    maze[y][x] = '-';
+    maze(x, y) = '-';
 
     int dx[] = {0, 1, 0, -1};
     int dy[] = {-1, 0, 1, 0};
@@ -58,23 +58,23 @@ void MazeGenerator::carvePath(int x, int y) {
         int nx = x + dx[dir] * 2;
         int ny = y + dy[dir] * 2;
 
-        if (isValid(nx, ny) && maze[ny][nx] == '+') {
-            maze[y + dy[dir]][x + dx[dir]] = '-';
+        if (isValid(nx, ny) && maze(nx, ny) == '+') {
+            maze(x + dx[dir], y + dy[dir]) = '-';
             carvePath(nx, ny);
         }
     }
 }
 
 void MazeGenerator::setStartEndPoints() {
-    std::cout << "Setting start and end points for maze of size " << width << "x" << height << std::endl;
+    LOG_DEBUG("Setting start and end points for maze of size " << width << "x" << height);
     
     // Try to set start point at top edge first
     bool startFound = false;
     for (int x = 1; x < width - 1; ++x) {
-        if (maze[1][x] == '-') {
+        if (maze(x, 1) == '-') {
             start = {x, 0};
-            maze[0][x] = 'I';
-            std::cout << "Start point set at top edge: (" << start.first << "," << start.second << ")" << std::endl;
+            maze(x, 0) = 'I';
+            LOG_DEBUG("Start point set at top edge: (" << start.first << "," << start.second << ")");
             startFound = true;
             break;
         }
@@ -82,14 +82,14 @@ void MazeGenerator::setStartEndPoints() {
     
     // If no start point found at top edge, try other rows
     if (!startFound) {
-        std::cout << "No suitable start point found at top edge, trying other rows..." << std::endl;
+        LOG_DEBUG("No suitable start point found at top edge, trying other rows...");
         
         // Try left edge
         for (int y = 1; y < height - 1; ++y) {
-            if (maze[y][1] == '-') {
+            if (maze(1, y) == '-') {
                 start = {0, y};
-                maze[y][0] = 'I';
-                std::cout << "Start point set at left edge: (" << start.first << "," << start.second << ")" << std::endl;
+                maze(0, y) = 'I';
+                LOG_DEBUG("Start point set at left edge: (" << start.first << "," << start.second << ")");
                 startFound = true;
                 break;
             }
@@ -99,16 +99,16 @@ void MazeGenerator::setStartEndPoints() {
         if (!startFound) {
             for (int y = 1; y < height - 1; ++y) {
                 for (int x = 1; x < width - 1; ++x) {
-                    if (maze[y][x] == '-') {
+                    if (maze(x, y) == '-') {
                         // Create an entrance adjacent to this path
                         if (x > 1) {
                             start = {x-1, y};
-                            maze[y][x-1] = 'I';
+                            maze(x-1, y) = 'I';
                         } else {
                             start = {x+1, y};
-                            maze[y][x+1] = 'I';
+                            maze(x+1, y) = 'I';
                         }
-                        std::cout << "Start point set at internal position: (" << start.first << "," << start.second << ")" << std::endl;
+                        LOG_DEBUG("Start point set at internal position: (" << start.first << "," << start.second << ")");
                         startFound = true;
                         break;
                     }
@@ -120,11 +120,11 @@ void MazeGenerator::setStartEndPoints() {
     
     // Verify that start point was set
     if (start.first == -1 || start.second == -1) {
-        std::cerr << "ERROR: Failed to set start point!" << std::endl;
+        LOG_ERROR("ERROR: Failed to set start point!");
         // Force a start point as last resort
         start = {1, 1};
-        maze[1][1] = 'I';
-        std::cout << "Forced start point at (1,1)" << std::endl;
+        maze(1, 1) = 'I';
+        LOG_DEBUG("Forced start point at (1,1)");
     }
 
     // Try to set end point at bottom edge first
@@ -132,10 +132,10 @@ void MazeGenerator::setStartEndPoints() {
     
     // Try from right to left at bottom edge
     for (int x = width - 2; x >= 1; --x) {
-        if (maze[height-2][x] == '-') {
+        if (maze(x, height-2) == '-') {
             end = {x, height-1};
-            maze[height-1][x] = 'O';
-            std::cout << "End point set at bottom edge: (" << end.first << "," << end.second << ")" << std::endl;
+            maze(x, height-1) = 'O';
+            LOG_DEBUG("End point set at bottom edge: (" << end.first << "," << end.second << ")");
             endFound = true;
             break;
         }
@@ -144,10 +144,10 @@ void MazeGenerator::setStartEndPoints() {
     // If not found, try from left to right at bottom edge
     if (!endFound) {
         for (int x = 1; x < width - 1; ++x) {
-            if (maze[height-2][x] == '-') {
+            if (maze(x, height-2) == '-') {
                 end = {x, height-1};
-                maze[height-1][x] = 'O';
-                std::cout << "End point set at bottom edge (left-to-right): (" << end.first << "," << end.second << ")" << std::endl;
+                maze(x, height-1) = 'O';
+                LOG_DEBUG("End point set at bottom edge (left-to-right): (" << end.first << "," << end.second << ")");
                 endFound = true;
                 break;
             }
@@ -156,12 +156,12 @@ void MazeGenerator::setStartEndPoints() {
     
     // If still not found, try right edge
     if (!endFound) {
-        std::cout << "No suitable end point found at bottom edge, trying right edge..." << std::endl;
+        LOG_DEBUG("No suitable end point found at bottom edge, trying right edge...");
         for (int y = height - 2; y >= 1; --y) {
-            if (maze[y][width-2] == '-') {
+            if (maze(width-2, y) == '-') {
                 end = {width-1, y};
-                maze[y][width-1] = 'O';
-                std::cout << "End point set at right edge: (" << end.first << "," << end.second << ")" << std::endl;
+                maze(width-1, y) = 'O';
+                LOG_DEBUG("End point set at right edge: (" << end.first << "," << end.second << ")");
                 endFound = true;
                 break;
             }
@@ -170,7 +170,7 @@ void MazeGenerator::setStartEndPoints() {
     
     // If still not found, pick any path cell far from start
     if (!endFound) {
-        std::cout << "No suitable end point found at edges, looking for any distant path cell..." << std::endl;
+        LOG_DEBUG("No suitable end point found at edges, looking for any distant path cell...");
         
         // Find a path cell that's far from start
         int maxDistance = 0;
@@ -178,7 +178,7 @@ void MazeGenerator::setStartEndPoints() {
         
         for (int y = height - 2; y >= 1; --y) {
             for (int x = width - 2; x >= 1; --x) {
-                if (maze[y][x] == '-') {
+                if (maze(x, y) == '-') {
                     int distance = std::abs(x - start.first) + std::abs(y - start.second);
                     if (distance > maxDistance) {
                         maxDistance = distance;
@@ -192,48 +192,81 @@ void MazeGenerator::setStartEndPoints() {
             // Make an exit adjacent to this point
             if (bestEnd.second < height-2) {
                 end = {bestEnd.first, bestEnd.second+1};
-                maze[bestEnd.second+1][bestEnd.first] = 'O';
+                maze(bestEnd.first, bestEnd.second+1) = 'O';
             } else {
                 end = {bestEnd.first, bestEnd.second-1};
-                maze[bestEnd.second-1][bestEnd.first] = 'O';
+                maze(bestEnd.first, bestEnd.second-1) = 'O';
             }
-            std::cout << "End point set at internal position: (" << end.first << "," << end.second << ")" << std::endl;
+            LOG_DEBUG("End point set at internal position: (" << end.first << "," << end.second << ")");
             endFound = true;
         }
     }
     
     // Verify that end point was set
     if (end.first == -1 || end.second == -1) {
-        std::cerr << "ERROR: Failed to set end point!" << std::endl;
+        LOG_ERROR("ERROR: Failed to set end point!");
         // Force an end point as last resort, opposite corner from start
         end = {width-2, height-2};
-        maze[height-2][width-2] = 'O';
-        std::cout << "Forced end point at (" << end.first << "," << end.second << ")" << std::endl;
+        maze(width-2, height-2) = 'O';
+        LOG_DEBUG("Forced end point at (" << end.first << "," << end.second << ")");
     }
     
     // Ensure start and end are different
     if (start.first == end.first && start.second == end.second) {
-        std::cerr << "ERROR: Start and end points are the same!" << std::endl;
+        LOG_ERROR("ERROR: Start and end points are the same!");
         // Force them to be different
         if (end.first < width-2) {
             end.first++;
         } else {
             end.first--;
         }
-        maze[end.second][end.first] = 'O';
-        std::cout << "Adjusted end point to avoid overlap: (" << end.first << "," << end.second << ")" << std::endl;
+        maze(end.first, end.second) = 'O';
+        LOG_DEBUG("Adjusted end point to avoid overlap: (" << end.first << "," << end.second << ")");
     }
     
     // Final verification
-    std::cout << "Final start point: (" << start.first << "," << start.second << ")" << std::endl;
-    std::cout << "Final end point: (" << end.first << "," << end.second << ")" << std::endl;
+    LOG_DEBUG("Final start point: (" << start.first << "," << start.second << ")");
+    LOG_DEBUG("Final end point: (" << end.first << "," << end.second << ")");
+}
+
+int MazeGenerator::addExits(int count) {
+    // Border cells (corners excluded) that would open onto a path cell
+    MyVector<std::pair<int, int>> candidates;
+    for (int x = 1; x < width - 1; ++x) {
+        if (maze(x, 0) == '+' && maze(x, 1) == '-') {
+            candidates.push_back({x, 0});
+        }
+        if (maze(x, height - 1) == '+' && maze(x, height - 2) == '-') {
+            candidates.push_back({x, height - 1});
+        }
+    }
+    for (int y = 1; y < height - 1; ++y) {
+        if (maze(0, y) == '+' && maze(1, y) == '-') {
+            candidates.push_back({0, y});
+        }
+        if (maze(width - 1, y) == '+' && maze(width - 2, y) == '-') {
+            candidates.push_back({width - 1, y});
+        }
+    }
+
+    int added = 0;
+    while (added < count && !candidates.empty()) {
+        size_t last = candidates.size() - 1;
+        std::swap(candidates[std::rand() % candidates.size()], candidates[last]);
+        std::pair<int, int> exit = candidates[last];
+        candidates.pop_back();
+        maze(exit.first, exit.second) = 'O';
+        ++added;
+    }
+    LOG_DEBUG("Added " << added << " extra exits");
+    return added;
 }
 
 bool MazeGenerator::isValid(int x, int y) const {
     return x > 0 && x < width - 1 && y > 0 && y < height - 1;
 }
 
-const MyVector<MyVector<char>>& MazeGenerator::getMaze() const {
+const Grid<char>& MazeGenerator::getMaze() const {
     return maze;
 }
 
@@ -243,4 +276,16 @@ std::pair<int, int> MazeGenerator::getStartPoint() const {
 
 std::pair<int, int> MazeGenerator::getEndPoint() const {
     return end;
+}
+
+MyVector<std::pair<int, int>> MazeGenerator::getExitPoints() const {
+    MyVector<std::pair<int, int>> exits;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (maze(x, y) == 'O') {
+                exits.push_back({x, y});
+            }
+        }
+    }
+    return exits;
 }
\ No newline at end of file
@@ -2,20 +2,25 @@
 #ifndef MAZE_GENERATOR_H
 #define MAZE_GENERATOR_H
 
-#include "myvector.h"
+#include "grid.h"
 #include <utility>
 
 class MazeGenerator {
 public:
     MazeGenerator(int width, int height);
     void generate();
-    const MyVector<MyVector<char>>& getMaze() const;
+    // Opens up to `count` extra 'O' cells on the border next to a path
+    // cell. Returns how many were added.
+    int addExits(int count);
+    const Grid<char>& getMaze() const;
     std::pair<int, int> getStartPoint() const;
     std::pair<int, int> getEndPoint() const;
+    // Every 'O' cell, the end point included.
+    MyVector<std::pair<int, int>> getExitPoints() const;
 
 private:
     int width, height;
-    MyVector<MyVector<char>> maze;
+    Grid<char> maze;
     std::pair<int, int> start, end;
 
     bool isValid(int x, int y) const;
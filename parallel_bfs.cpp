@@ -0,0 +1,206 @@
+// parallel_bfs.cpp
+#include "parallel_bfs.h"
+#include "log.h"
+#include <thread>
+
+// Frontier cells handed out per atomic increment of the shared cursor
+static const size_t chunkSize = 256;
+
+ParallelBfs::Barrier::Barrier(unsigned parties) : parties(parties), arrived(0), phase(0) {}
+
+void ParallelBfs::Barrier::wait() {
+    // The lock also orders worker 0's writes between barriers before every
+    // other worker's reads after them.
+    std::unique_lock<std::mutex> guard(lock);
+    unsigned current = phase;
+    if (++arrived == parties) {
+        arrived = 0;
+        ++phase;
+        released.notify_all();
+        return;
+    }
+    released.wait(guard, [this, current] { return phase != current; });
+}
+
+// Per-query state shared by the workers. Fields other than the atomics are
+// written by worker 0 between two barriers and only read otherwise.
+struct ParallelBfs::Level {
+    explicit Level(unsigned lanes)
+        : barrier(lanes), lanes(lanes), offsets(lanes + 1, 0), goal(-1), parity(0), level(0), cursor(0),
+          found(false), done(false) {}
+
+    Barrier barrier;
+    unsigned lanes;
+    MyVector<size_t> offsets; // lane l holds frontier entries [offsets[l], offsets[l + 1])
+    int goal;
+    int parity;
+    int level;
+    std::atomic<size_t> cursor;
+    std::atomic<bool> found;
+    bool done;
+};
+
+ParallelBfs::ParallelBfs(const Grid<unsigned char>& moves, unsigned threadCount)
+    : moves(moves), width(moves.width()), threadCount(1), minParallelCells(1 << 16), stamp(0),
+      lastLevels(0) {
+    setThreadCount(threadCount);
+}
+
+void ParallelBfs::setThreadCount(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    this->threadCount = threadCount > 0 ? threadCount : 1;
+    lanes = std::vector<Lane>(this->threadCount);
+    pool.reset();
+}
+
+unsigned ParallelBfs::getThreadCount() const {
+    return threadCount;
+}
+
+void ParallelBfs::setMinParallelCells(size_t cells) {
+    minParallelCells = cells;
+}
+
+size_t ParallelBfs::getMinParallelCells() const {
+    return minParallelCells;
+}
+
+int ParallelBfs::getLastLevels() const {
+    return lastLevels;
+}
+
+bool ParallelBfs::claim(int cell) {
+    // The plain load filters out most repeat visits without a write
+    std::atomic<unsigned>& slot = claimed[cell];
+    return slot.load(std::memory_order_relaxed) != stamp &&
+           slot.exchange(stamp, std::memory_order_relaxed) != stamp;
+}
+
+MyVector<std::pair<int, int>> ParallelBfs::findPath(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    MyVector<std::pair<int, int>> path;
+    if (!claimed) {
+        // Allocated on first use: a solver that never runs this mode pays nothing
+        depth = Grid<int>(moves.width(), moves.height());
+        claimed.reset(new std::atomic<unsigned>[moves.size()]);
+        for (size_t i = 0; i < moves.size(); ++i) {
+            claimed[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    if (++stamp == 0) {
+        for (size_t i = 0; i < moves.size(); ++i) {
+            claimed[i].store(0, std::memory_order_relaxed);
+        }
+        stamp = 1;
+    }
+
+    unsigned workers = moves.size() < minParallelCells ? 1 : threadCount;
+    Level shared(workers);
+    int source = static_cast<int>(moves.index(start.first, start.second));
+    shared.goal = static_cast<int>(moves.index(end.first, end.second));
+    claim(source);
+    depth[source] = 0;
+    for (unsigned lane = 0; lane < workers; ++lane) {
+        lanes[lane].cells[0].resize(0);
+    }
+    lanes[0].cells[0].push_back(source);
+    size_t* offsets = shared.offsets.begin();
+    for (unsigned lane = 0; lane < workers; ++lane) {
+        offsets[lane + 1] = offsets[lane] + lanes[lane].cells[0].size();
+    }
+    shared.done = (source == shared.goal);
+
+    if (!shared.done && workers == 1) {
+        runWorker(0, shared);
+    } else if (!shared.done) {
+        if (!pool) {
+            pool.reset(new ThreadPool(threadCount));
+        }
+        pool->run([this, &shared](unsigned id) { runWorker(id, shared); });
+    }
+    lastLevels = shared.level;
+    LOG_DEBUG("Level-synchronous BFS expanded " << shared.level << " levels on " << workers << " threads");
+
+    if (claimed[shared.goal].load(std::memory_order_relaxed) != stamp) {
+        return path;
+    }
+
+    // Walk back one level at a time; moves are symmetric, so any claimed
+    // neighbour one level closer to the start lies on a shortest route.
+    const int offset[4] = {-width, 1, width, -1};
+    int at = shared.goal;
+    path.reserve(depth[at] + 1);
+    path.push_back({moves.xOf(at), moves.yOf(at)});
+    while (depth[at] > 0) {
+        unsigned char open = moves[at];
+        for (int dir = 0; dir < 4; ++dir) {
+            int next = at + offset[dir];
+            if ((open & (1 << dir)) && claimed[next].load(std::memory_order_relaxed) == stamp &&
+                depth[next] == depth[at] - 1) {
+                at = next;
+                break;
+            }
+        }
+        path.push_back({moves.xOf(at), moves.yOf(at)});
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void ParallelBfs::runWorker(unsigned id, Level& shared) {
+    const int offset[4] = {-width, 1, width, -1};
+    const unsigned char* open = moves.data();
+    int* levels = depth.data();
+    const size_t* offsets = shared.offsets.begin();
+
+    while (true) {
+        int parity = shared.parity;
+        int nextLevel = shared.level + 1;
+        size_t total = offsets[shared.lanes];
+        MyVector<int>& out = lanes[id].cells[parity ^ 1];
+        out.resize(0);
+
+        for (size_t begin = shared.cursor.fetch_add(chunkSize); begin < total;
+             begin = shared.cursor.fetch_add(chunkSize)) {
+            size_t end = std::min(begin + chunkSize, total);
+            unsigned lane = 0;
+            for (size_t i = begin; i < end; ++i) {
+                while (offsets[lane + 1] <= i) {
+                    ++lane;
+                }
+                int cell = lanes[lane].cells[parity].begin()[i - offsets[lane]];
+                unsigned char mask = open[cell];
+                for (int dir = 0; dir < 4; ++dir) {
+                    if (!(mask & (1 << dir))) {
+                        continue;
+                    }
+                    int next = cell + offset[dir];
+                    if (claim(next)) {
+                        levels[next] = nextLevel;
+                        out.push_back(next);
+                        if (next == shared.goal) {
+                            shared.found.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            }
+        }
+        shared.barrier.wait();
+
+        if (id == 0) {
+            size_t* sizes = shared.offsets.begin();
+            for (unsigned lane = 0; lane < shared.lanes; ++lane) {
+                sizes[lane + 1] = sizes[lane] + lanes[lane].cells[parity ^ 1].size();
+            }
+            shared.parity = parity ^ 1;
+            shared.level = nextLevel;
+            shared.cursor.store(0, std::memory_order_relaxed);
+            shared.done = shared.found.load(std::memory_order_relaxed) || sizes[shared.lanes] == 0;
+        }
+        shared.barrier.wait();
+        if (shared.done) {
+            return;
+        }
+    }
+}
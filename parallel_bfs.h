@@ -0,0 +1,84 @@
+// parallel_bfs.h
+#ifndef PARALLEL_BFS_H
+#define PARALLEL_BFS_H
+
+#include "grid.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Level-synchronous breadth-first search over the solver's move masks. Each
+// level is expanded by all threads at once: they take chunks of the current
+// frontier, claim unseen neighbours with one atomic exchange per cell and
+// append them to a per-thread buffer. Those buffers together are the next
+// frontier, so nothing is merged or copied between levels.
+//
+// Levels are exact BFS distances, so paths have the same length as the
+// other solvers'. Below the parallel threshold the level barriers cost more
+// than they save; dekstra sends such mazes to its sequential breadth-first
+// search instead, and a direct call runs the loop on the calling thread.
+// Larger mazes run on a pool of threadCount workers started by the first
+// parallel query and kept until the thread count changes.
+class ParallelBfs {
+public:
+    // threadCount 0 picks one thread per hardware thread.
+    explicit ParallelBfs(const Grid<unsigned char>& moves, unsigned threadCount = 0);
+
+    MyVector<std::pair<int, int>> findPath(const std::pair<int, int>& start, const std::pair<int, int>& end);
+
+    void setThreadCount(unsigned threadCount);
+    unsigned getThreadCount() const;
+    // Mazes with fewer cells than this run on one thread.
+    void setMinParallelCells(size_t cells);
+    size_t getMinParallelCells() const;
+    // Levels expanded by the last findPath.
+    int getLastLevels() const;
+
+private:
+    // One per thread, padded so neighbouring threads' push_back calls do not
+    // share a cache line.
+    struct alignas(64) Lane {
+        MyVector<int> cells[2]; // frontier written at even and odd levels
+    };
+
+    // Blocks each caller until all parties have arrived, so workers waiting
+    // on a slow level sleep instead of spinning.
+    class Barrier {
+    public:
+        explicit Barrier(unsigned parties);
+        void wait();
+
+    private:
+        unsigned parties;
+        unsigned arrived;
+        unsigned phase;
+        std::mutex lock;
+        std::condition_variable released;
+    };
+
+    struct Level;
+
+    const Grid<unsigned char>& moves;
+    int width;
+    unsigned threadCount;
+    size_t minParallelCells;
+
+    // Cell i belongs to the current search when claimed[i] == stamp; its
+    // level is then depth[i].
+    std::unique_ptr<std::atomic<unsigned>[]> claimed;
+    unsigned stamp;
+    Grid<int> depth;
+    std::vector<Lane> lanes;
+    std::unique_ptr<ThreadPool> pool;
+    int lastLevels;
+
+    void runWorker(unsigned id, Level& shared);
+    bool claim(int cell);
+};
+
+#endif // PARALLEL_BFS_H
@@ -0,0 +1,54 @@
+// path_cache.cpp
+#include "path_cache.h"
+
+PathCache::PathCache(dekstra& solver, size_t capacity)
+    : solver(solver), capacity(capacity > 0 ? capacity : 1), revision(solver.getRevision()),
+      hits(0), misses(0) {}
+
+const MyVector<std::pair<int, int>>& PathCache::findShortestPath(const std::pair<int, int>& start,
+                                                                 const std::pair<int, int>& end) {
+    if (solver.getRevision() != revision) {
+        clear();
+        revision = solver.getRevision();
+    }
+
+    Key key = {start.first, start.second, end.first, end.second, revision, solver.getSearchMode(),
+               solver.getExactRefinement()};
+    auto found = index.find(key);
+    if (found != index.end()) {
+        ++hits;
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->second;
+    }
+
+    ++misses;
+    if (entries.size() >= capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.push_front({key, solver.findShortestPath(start, end)});
+    index[key] = entries.begin();
+    return entries.front().second;
+}
+
+void PathCache::clear() {
+    entries.clear();
+    index.clear();
+}
+
+size_t PathCache::size() const {
+    return entries.size();
+}
+
+size_t PathCache::getHits() const {
+    return hits;
+}
+
+size_t PathCache::getMisses() const {
+    return misses;
+}
+
+void PathCache::resetStats() {
+    hits = 0;
+    misses = 0;
+}
@@ -0,0 +1,67 @@
+// path_cache.h
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include "dekstra.h"
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Memoises dekstra::findShortestPath results keyed on (start, end, maze
+// revision, search mode, exact refinement), with least-recently-used
+// eviction. The mode and refinement flag are part of the key because the
+// hierarchical mode returns approximate routes. Entries from an older
+// revision can never be hit and are dropped as soon as the solver reports a
+// new one, so callers only have to keep calling dekstra::onMazeChanged().
+class PathCache {
+public:
+    explicit PathCache(dekstra& solver, size_t capacity = 64);
+
+    // The returned reference stays valid until the next call on the cache.
+    const MyVector<std::pair<int, int>>& findShortestPath(const std::pair<int, int>& start,
+                                                          const std::pair<int, int>& end);
+
+    void clear();
+    size_t size() const;
+    size_t getHits() const;
+    size_t getMisses() const;
+    void resetStats();
+
+private:
+    struct Key {
+        int startX, startY, endX, endY;
+        unsigned revision;
+        SearchMode mode;
+        bool exact;
+
+        bool operator==(const Key& other) const {
+            return startX == other.startX && startY == other.startY &&
+                   endX == other.endX && endY == other.endY && revision == other.revision &&
+                   mode == other.mode && exact == other.exact;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            size_t hash = static_cast<size_t>(key.revision);
+            const int parts[6] = {key.startX, key.startY, key.endX, key.endY, static_cast<int>(key.mode), key.exact};
+            for (int part : parts) {
+                hash = hash * 1000003u ^ static_cast<size_t>(part);
+            }
+            return hash;
+        }
+    };
+
+    typedef std::list<std::pair<Key, MyVector<std::pair<int, int>>>> EntryList;
+
+    dekstra& solver;
+    size_t capacity;
+    unsigned revision;
+    EntryList entries; // most recently used first
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+    size_t hits;
+    size_t misses;
+};
+
+#endif // PATH_CACHE_H
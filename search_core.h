@@ -0,0 +1,538 @@
+// search_core.h
+#ifndef SEARCH_CORE_H
+#define SEARCH_CORE_H
+
+#include "frontier_queue.h"
+#include "grid.h"
+#include "search_labels.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// One-sided best-first search assembled from policies, so each combination
+// is compiled into its own loop with no virtual calls or per-step switches:
+//
+//   Cost       distance type (int, double, ...)
+//   Neighbors  which cells a cell connects to, e.g. FourNeighbors or
+//              EightNeighbors over dekstra's move masks. Calls
+//              visit(next, diagonal) for each of them.
+//   Cells      cost of one step into a cell: cost(next, diagonal).
+//   Queue      frontier order. firstReachFinal says the first label a cell
+//              gets is its final distance, which only holds for a FIFO with
+//              equal step costs; the core then drops the settled check and
+//              stops as soon as the target is labelled.
+//
+// Neighbors and Cells only look at the cell index, so they work with any
+// Grid laid out row-major.
+
+// Steps through dekstra's 4-bit masks (bit i = N, E, S, W is open).
+class FourNeighbors {
+public:
+    explicit FourNeighbors(const Grid<unsigned char>& moves)
+        : moves(moves.data()), offset{-moves.width(), 1, moves.width(), -1} {}
+
+    template <typename Visit>
+    void forEach(int cell, Visit&& visit) const {
+        unsigned char open = moves[cell];
+        for (int dir = 0; dir < 4; ++dir) {
+            if (open & (1 << dir)) {
+                visit(cell + offset[dir], false);
+            }
+        }
+    }
+
+private:
+    const unsigned char* moves;
+    int offset[4];
+};
+
+// FourNeighbors plus diagonal steps. A diagonal is open only when both
+// L-shaped routes to it are, so paths never cut a wall corner.
+class EightNeighbors {
+public:
+    explicit EightNeighbors(const Grid<unsigned char>& moves)
+        : moves(moves.data()), offset{-moves.width(), 1, moves.width(), -1} {}
+
+    template <typename Visit>
+    void forEach(int cell, Visit&& visit) const {
+        unsigned char open = moves[cell];
+        for (int dir = 0; dir < 4; ++dir) {
+            if (open & (1 << dir)) {
+                visit(cell + offset[dir], false);
+            }
+        }
+        for (int a = 0; a < 4; ++a) {
+            int b = (a + 1) & 3;
+            if ((open & (1 << a)) && (open & (1 << b)) && (moves[cell + offset[a]] & (1 << b)) &&
+                (moves[cell + offset[b]] & (1 << a))) {
+                visit(cell + offset[a] + offset[b], true);
+            }
+        }
+    }
+
+private:
+    const unsigned char* moves;
+    int offset[4];
+};
+
+// Every step costs one.
+template <typename Cost>
+struct UnitCells {
+    Cost cost(int, bool) const {
+        return Cost(1);
+    }
+};
+
+// Straight and diagonal steps with their own costs, e.g. 1 and sqrt(2).
+template <typename Cost>
+struct OctileCells {
+    Cost straight;
+    Cost diagonal;
+
+    Cost cost(int, bool isDiagonal) const {
+        return isDiagonal ? diagonal : straight;
+    }
+};
+
+// Entering a cell costs weights[cell], whichever way it is entered.
+// Weights must not be negative.
+template <typename Cost>
+struct WeightedCells {
+    const Cost* weights;
+
+    Cost cost(int next, bool) const {
+        return weights[next];
+    }
+};
+
+template <typename Cost>
+class FifoPolicy {
+public:
+    static const bool firstReachFinal = true;
+
+    FifoPolicy() : head(0) {}
+    void push(Cost, int cell) {
+        cells.push_back(cell);
+    }
+    int pop(Cost& key) {
+        key = Cost(0);
+        return cells.begin()[head++];
+    }
+    bool empty() const {
+        return head == cells.size();
+    }
+    void clear() {
+        cells.resize(0);
+        head = 0;
+    }
+
+private:
+    MyVector<int> cells;
+    size_t head;
+};
+
+// Binary min-heap on (key, cell); works for any ordered Cost.
+template <typename Cost>
+class HeapPolicy {
+public:
+    static const bool firstReachFinal = false;
+
+    void push(Cost key, int cell) {
+        heap.push_back({key, cell});
+        std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<Cost, int>>());
+    }
+    int pop(Cost& key) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<Cost, int>>());
+        key = heap.back().first;
+        int cell = heap.back().second;
+        heap.pop_back();
+        return cell;
+    }
+    bool empty() const {
+        return heap.empty();
+    }
+    void clear() {
+        heap.clear();
+    }
+
+private:
+    std::vector<std::pair<Cost, int>> heap;
+};
+
+// One FrontierQueue backend, fixed at compile time; int keys only.
+template <QueueKind Kind>
+class FrontierPolicy : public FrontierBackend<Kind> {
+public:
+    static const bool firstReachFinal = false;
+};
+
+template <typename Cost>
+struct ZeroCellHeuristic {
+    Cost operator()(int) const {
+        return Cost(0);
+    }
+};
+
+template <typename Cost, typename Neighbors, typename Cells, typename Queue>
+class SearchCore {
+public:
+    SearchCore(const Neighbors& neighbors, const Cells& cells, size_t cellCount);
+
+    // Cheapest route from source to target; false when there is none.
+    // heuristic(cell) must be a consistent lower bound on the remaining cost.
+    bool run(int source, int target);
+    template <typename Heuristic>
+    bool run(int source, int target, const Heuristic& heuristic);
+
+    // Valid for cells labelled by the last run, the target included.
+    Cost distance(int cell) const;
+    // Cells from the source to `target` along the last run's tree.
+    MyVector<int> tracePath(int target) const;
+
+private:
+    Neighbors neighbors;
+    Cells cells;
+    Queue queue;
+    // A cell is labelled when reached[cell] == stamp and settled when
+    // closed[cell] == stamp; dist and parent are only valid once labelled.
+    // Allocated by the first run; closed stays empty for FIFO queues,
+    // which never settle a cell twice.
+    size_t cellCount;
+    MyVector<Cost> dist;
+    MyVector<int> parent;
+    MyVector<unsigned> reached;
+    MyVector<unsigned> closed;
+    unsigned stamp;
+};
+
+template <typename Cost, typename Neighbors, typename Cells, typename Queue>
+SearchCore<Cost, Neighbors, Cells, Queue>::SearchCore(const Neighbors& neighbors, const Cells& cells, size_t cellCount)
+    : neighbors(neighbors), cells(cells), cellCount(cellCount), stamp(0) {}
+
+template <typename Cost, typename Neighbors, typename Cells, typename Queue>
+bool SearchCore<Cost, Neighbors, Cells, Queue>::run(int source, int target) {
+    return run(source, target, ZeroCellHeuristic<Cost>());
+}
+
+template <typename Cost, typename Neighbors, typename Cells, typename Queue>
+template <typename Heuristic>
+bool SearchCore<Cost, Neighbors, Cells, Queue>::run(int source, int target, const Heuristic& heuristic) {
+    if (reached.size() != cellCount) {
+        dist = MyVector<Cost>(cellCount);
+        parent = MyVector<int>(cellCount);
+        reached = MyVector<unsigned>(cellCount, 0);
+        if (!Queue::firstReachFinal) {
+            closed = MyVector<unsigned>(cellCount, 0);
+        }
+        stamp = 0;
+    }
+    if (++stamp == 0) {
+        std::fill(reached.begin(), reached.end(), 0u);
+        std::fill(closed.begin(), closed.end(), 0u);
+        stamp = 1;
+    }
+    Cost* distances = dist.begin();
+    int* parents = parent.begin();
+    unsigned* labelled = reached.begin();
+    unsigned* settled = closed.begin();
+
+    queue.clear();
+    distances[source] = Cost(0);
+    parents[source] = -1;
+    labelled[source] = stamp;
+    if (source == target) {
+        return true;
+    }
+    queue.push(heuristic(source), source);
+
+    bool found = false;
+    while (!queue.empty()) {
+        Cost key;
+        int cell = queue.pop(key);
+        if (!Queue::firstReachFinal) {
+            if (settled[cell] == stamp) {
+                continue; // Stale entry left behind by an earlier improvement
+            }
+            settled[cell] = stamp;
+            if (cell == target) {
+                return true;
+            }
+        }
+
+        Cost base = distances[cell];
+        neighbors.forEach(cell, [&](int next, bool diagonal) {
+            Cost through = base + cells.cost(next, diagonal);
+            if (labelled[next] != stamp || (!Queue::firstReachFinal && through < distances[next])) {
+                labelled[next] = stamp;
+                distances[next] = through;
+                parents[next] = cell;
+                queue.push(through + heuristic(next), next);
+                if (Queue::firstReachFinal && next == target) {
+                    found = true;
+                }
+            }
+        });
+        if (found) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Cost, typename Neighbors, typename Cells, typename Queue>
+Cost SearchCore<Cost, Neighbors, Cells, Queue>::distance(int cell) const {
+    return dist.begin()[cell];
+}
+
+template <typename Cost, typename Neighbors, typename Cells, typename Queue>
+MyVector<int> SearchCore<Cost, Neighbors, Cells, Queue>::tracePath(int target) const {
+    MyVector<int> route;
+    for (int at = target; at != -1; at = parent.begin()[at]) {
+        route.push_back(at);
+    }
+    std::reverse(route.begin(), route.end());
+    return route;
+}
+
+// Two-sided search over unit-cost move masks, for the modes that grow a
+// tree from each end (or only from the start, with the end as the other
+// tree's lone root). SearchWorkspace holds everything one query writes, so
+// one search at a time can run per workspace and a thread that owns one
+// needs nothing else but read-only masks.
+struct SearchWorkspace {
+    SearchWorkspace();
+    SearchWorkspace(int width, int height, const int offset[4]);
+
+    // Forgets the last query and switches both frontiers to `kind`.
+    void begin(QueueKind kind);
+    // Keeps the route of length cost through cell if it is the best so far.
+    void offer(int cost, int cell);
+    // Cells from the forward root through meetCell to the backward root it
+    // leads to; empty when the trees never met.
+    MyVector<int> tracePath() const;
+
+    SearchLabels labels;        // forward tree
+    SearchLabels labelsFromEnd; // backward tree
+    FrontierQueue pq;
+    FrontierQueue pqFromEnd;
+    // Cheapest route seen so far and the cell where it joins the two trees.
+    int bestCost;
+    int meetCell;
+    // Cells each side aims its heuristic at, and the cells expanded last.
+    int forwardGoal;
+    int backwardGoal;
+    int current;
+    int currentFromEnd;
+};
+
+inline SearchWorkspace::SearchWorkspace()
+    : bestCost(std::numeric_limits<int>::max()), meetCell(-1), forwardGoal(-1), backwardGoal(-1), current(-1),
+      currentFromEnd(-1) {}
+
+inline SearchWorkspace::SearchWorkspace(int width, int height, const int offset[4])
+    : labels(width, height, offset), labelsFromEnd(width, height, offset), bestCost(std::numeric_limits<int>::max()),
+      meetCell(-1), forwardGoal(-1), backwardGoal(-1), current(-1), currentFromEnd(-1) {}
+
+inline void SearchWorkspace::begin(QueueKind kind) {
+    labels.begin();
+    labelsFromEnd.begin();
+    if (pq.getKind() != kind) {
+        pq.setKind(kind);
+        pqFromEnd.setKind(kind);
+    } else {
+        pq.clear();
+        pqFromEnd.clear();
+    }
+    bestCost = std::numeric_limits<int>::max();
+    meetCell = -1;
+    current = -1;
+    currentFromEnd = -1;
+}
+
+inline void SearchWorkspace::offer(int cost, int cell) {
+    if (cost < bestCost) {
+        bestCost = cost;
+        meetCell = cell;
+    }
+}
+
+inline MyVector<int> SearchWorkspace::tracePath() const {
+    MyVector<int> route;
+    if (meetCell < 0) {
+        return route;
+    }
+    for (int at = meetCell; at != -1; at = labels.parent(at)) {
+        route.push_back(at);
+    }
+    std::reverse(route.begin(), route.end());
+    for (int at = labelsFromEnd.parent(meetCell); at != -1; at = labelsFromEnd.parent(at)) {
+        route.push_back(at);
+    }
+    return route;
+}
+
+// Stop rules for BidirectionalCore. Each gets the smallest key of both
+// frontiers and the best route cost so far, with both frontiers non-empty
+// (only the forward one for one-sided rules).
+struct BlindMeeting {
+    static const bool twoSided = true;
+    // Once the two smallest keys add up to the best cost, no unexplored
+    // route can beat it.
+    static bool done(int forwardKey, int backwardKey, int best) {
+        return forwardKey + backwardKey >= best;
+    }
+};
+
+struct ForwardAStar {
+    static const bool twoSided = false;
+    static bool done(int forwardKey, int, int best) {
+        return forwardKey >= best;
+    }
+};
+
+struct MeetingAStar {
+    static const bool twoSided = true;
+    // Keys are lower bounds on the full route through the cell, so either
+    // frontier reaching the best cost proves it optimal.
+    static bool done(int forwardKey, int backwardKey, int best) {
+        return forwardKey >= best || backwardKey >= best;
+    }
+};
+
+// Meeting rule of a single-threaded search: a neighbour the other tree has
+// labelled closes a route through it.
+struct LabelMeeting {
+    SearchWorkspace& workspace;
+
+    void settled(int, const SearchLabels&, const SearchLabels&) {}
+    void reached(int next, const SearchLabels& side, const SearchLabels& other) {
+        if (other.isReached(next)) {
+            workspace.offer(side.distance(next) + other.distance(next), next);
+        }
+    }
+};
+
+// The loop over a SearchWorkspace, compiled per queue kind and stop rule.
+// Heuristics are called as h(x, y, goalX, goalY) (see heuristics.h); the
+// forward side aims at workspace.forwardGoal and the backward side at
+// workspace.backwardGoal. The caller seeds roots and frontiers.
+template <QueueKind Kind, typename Stop>
+class BidirectionalCore {
+public:
+    typedef FrontierBackend<Kind> Queue;
+
+    BidirectionalCore(const Grid<unsigned char>& moves, SearchWorkspace& workspace);
+
+    // Expands one cell on each side; false, without expanding, once the
+    // best route is proven or a frontier has run dry.
+    template <typename Heuristic>
+    bool advance(const Heuristic& heuristic);
+    template <typename Heuristic>
+    void run(const Heuristic& heuristic);
+    bool shouldStop();
+    // The frontier grown from the start, or from the end.
+    Queue& frontier(bool fromStart) const;
+
+    // Settles the smallest entry of `queue` and labels its neighbours in
+    // `side`, telling `meet` about the settled cell and each neighbour.
+    // Returns the cell popped.
+    template <typename Heuristic, typename Meet>
+    int expand(Queue& queue, SearchLabels& side, const SearchLabels& other, int goal, const Heuristic& heuristic,
+               Meet& meet) const;
+
+private:
+    static const int dx[4];
+    static const int dy[4];
+
+    const unsigned char* moves;
+    int width;
+    int offset[4];
+    SearchWorkspace& workspace;
+    Queue& forward;
+    Queue& backward;
+};
+
+template <QueueKind Kind, typename Stop>
+const int BidirectionalCore<Kind, Stop>::dx[4] = {0, 1, 0, -1};
+
+template <QueueKind Kind, typename Stop>
+const int BidirectionalCore<Kind, Stop>::dy[4] = {-1, 0, 1, 0};
+
+template <QueueKind Kind, typename Stop>
+BidirectionalCore<Kind, Stop>::BidirectionalCore(const Grid<unsigned char>& moves, SearchWorkspace& workspace)
+    : moves(moves.data()), width(moves.width()), offset{-moves.width(), 1, moves.width(), -1}, workspace(workspace),
+      forward(workspace.pq.backend<Kind>()), backward(workspace.pqFromEnd.backend<Kind>()) {}
+
+template <QueueKind Kind, typename Stop>
+bool BidirectionalCore<Kind, Stop>::shouldStop() {
+    if (forward.empty() || (Stop::twoSided && backward.empty())) {
+        return true;
+    }
+    if (workspace.bestCost == std::numeric_limits<int>::max()) {
+        return false;
+    }
+    return Stop::done(forward.topKey(), Stop::twoSided ? backward.topKey() : 0, workspace.bestCost);
+}
+
+template <QueueKind Kind, typename Stop>
+typename BidirectionalCore<Kind, Stop>::Queue& BidirectionalCore<Kind, Stop>::frontier(bool fromStart) const {
+    return fromStart ? forward : backward;
+}
+
+template <QueueKind Kind, typename Stop>
+template <typename Heuristic>
+bool BidirectionalCore<Kind, Stop>::advance(const Heuristic& heuristic) {
+    if (shouldStop()) {
+        return false;
+    }
+    LabelMeeting meet{workspace};
+    workspace.current = expand(forward, workspace.labels, workspace.labelsFromEnd, workspace.forwardGoal, heuristic, meet);
+    if (Stop::twoSided && !shouldStop()) {
+        workspace.currentFromEnd =
+            expand(backward, workspace.labelsFromEnd, workspace.labels, workspace.backwardGoal, heuristic, meet);
+    }
+    return true;
+}
+
+template <QueueKind Kind, typename Stop>
+template <typename Heuristic>
+void BidirectionalCore<Kind, Stop>::run(const Heuristic& heuristic) {
+    while (advance(heuristic)) {
+    }
+}
+
+template <QueueKind Kind, typename Stop>
+template <typename Heuristic, typename Meet>
+int BidirectionalCore<Kind, Stop>::expand(Queue& queue, SearchLabels& side, const SearchLabels& other, int goal,
+                                          const Heuristic& heuristic, Meet& meet) const {
+    int key;
+    int cell = queue.pop(key);
+    if (side.isSettled(cell)) {
+        return cell; // Stale entry left behind by an earlier improvement
+    }
+    side.settle(cell);
+    meet.settled(cell, side, other);
+
+    int x = cell % width;
+    int y = cell / width;
+    int goalX = goal % width;
+    int goalY = goal / width;
+    int newDist = side.distance(cell) + 1;
+    unsigned char open = moves[cell];
+    for (int dir = 0; dir < 4; ++dir) {
+        if (!(open & (1 << dir))) {
+            continue;
+        }
+        int next = cell + offset[dir];
+        if (!side.isReached(next) || newDist < side.distance(next)) {
+            side.label(next, newDist, (dir + 2) & 3);
+            queue.push(newDist + heuristic(x + dx[dir], y + dy[dir], goalX, goalY), next);
+        }
+        meet.reached(next, side, other);
+    }
+    return cell;
+}
+
+#endif // SEARCH_CORE_H
@@ -0,0 +1,43 @@
+// search_labels.cpp
+#include "search_labels.h"
+
+SearchLabels::SearchLabels() : stamp(1), narrow(true) {
+    for (int i = 0; i < 4; ++i) {
+        offset[i] = 0;
+    }
+}
+
+SearchLabels::SearchLabels(int width, int height, const int offset[4])
+    : stamp(1), narrow(static_cast<size_t>(width) * height <= 65535),
+      flags((((static_cast<size_t>(width) * height) >> blockShift) + 1) << blockShift, 0),
+      blockStamps(((static_cast<size_t>(width) * height) >> blockShift) + 1, 0) {
+    for (int i = 0; i < 4; ++i) {
+        this->offset[i] = offset[i];
+    }
+    // A path visits each cell at most once, so with fewer than 65536 cells
+    // no distance reaches 65535.
+    if (narrow) {
+        narrowDistances = MyVector<uint16_t>(static_cast<size_t>(width) * height);
+    } else {
+        wideDistances = MyVector<int>(static_cast<size_t>(width) * height);
+    }
+}
+
+void SearchLabels::begin() {
+    ++stamp;
+    if (stamp == 0) {
+        for (size_t i = 0; i < blockStamps.size(); ++i) {
+            blockStamps[i] = 0;
+        }
+        stamp = 1;
+    }
+}
+
+bool SearchLabels::isNarrow() const {
+    return narrow;
+}
+
+size_t SearchLabels::memoryUsage() const {
+    return flags.size() + blockStamps.size() * sizeof(unsigned) + narrowDistances.size() * sizeof(uint16_t) +
+           wideDistances.size() * sizeof(int);
+}
@@ -0,0 +1,118 @@
+// search_labels.h
+#ifndef SEARCH_LABELS_H
+#define SEARCH_LABELS_H
+
+#include "grid.h"
+#include <cstdint>
+
+// Per-cell labels of one search direction, packed to a few bytes per cell:
+// a flags byte holding the 2-bit direction of the parent plus root, reached
+// and settled bits, and a distance kept in 16 bits whenever every distance
+// in the maze fits (fewer than 65536 cells) and in 32 bits otherwise.
+//
+// Flags are cleared lazily in blocks of 64 cells: a block whose stamp is
+// older than the current query reads as untouched and is wiped the first
+// time a cell in it is labelled, so begin() stays O(1).
+class SearchLabels {
+public:
+    SearchLabels();
+    // offset[i] is the change in cell index for direction i (N, E, S, W).
+    SearchLabels(int width, int height, const int offset[4]);
+
+    // Forgets every label.
+    void begin();
+
+    bool isReached(int cell) const;
+    bool isSettled(int cell) const;
+    // Only meaningful for reached cells.
+    int distance(int cell) const;
+    // Parent cell, or -1 for a root.
+    int parent(int cell) const;
+
+    void setRoot(int cell);
+    // Labels `cell` with `distance`, reached from the neighbour in direction
+    // parentDir.
+    void label(int cell, int distance, int parentDir);
+    void settle(int cell);
+
+    bool isNarrow() const;
+    size_t memoryUsage() const;
+
+private:
+    static const unsigned char parentMask = 3;
+    static const unsigned char rootBit = 4;
+    static const unsigned char reachedBit = 8;
+    static const unsigned char settledBit = 16;
+    static const int blockShift = 6;
+
+    int offset[4];
+    unsigned stamp;
+    bool narrow;
+    MyVector<unsigned char> flags;
+    MyVector<unsigned> blockStamps;
+    MyVector<uint16_t> narrowDistances;
+    MyVector<int> wideDistances;
+
+    unsigned char flagsOf(int cell) const;
+    unsigned char& touch(int cell);
+    void setDistance(int cell, int distance);
+};
+
+inline unsigned char SearchLabels::flagsOf(int cell) const {
+    return blockStamps.begin()[cell >> blockShift] == stamp ? flags.begin()[cell] : 0;
+}
+
+inline unsigned char& SearchLabels::touch(int cell) {
+    unsigned& blockStamp = blockStamps.begin()[cell >> blockShift];
+    if (blockStamp != stamp) {
+        unsigned char* block = flags.begin() + (static_cast<size_t>(cell >> blockShift) << blockShift);
+        for (int i = 0; i < (1 << blockShift); ++i) {
+            block[i] = 0;
+        }
+        blockStamp = stamp;
+    }
+    return flags.begin()[cell];
+}
+
+inline bool SearchLabels::isReached(int cell) const {
+    return (flagsOf(cell) & reachedBit) != 0;
+}
+
+inline bool SearchLabels::isSettled(int cell) const {
+    return (flagsOf(cell) & settledBit) != 0;
+}
+
+inline int SearchLabels::distance(int cell) const {
+    return narrow ? narrowDistances.begin()[cell] : wideDistances.begin()[cell];
+}
+
+inline int SearchLabels::parent(int cell) const {
+    unsigned char bits = flagsOf(cell);
+    return (bits & rootBit) ? -1 : cell + offset[bits & parentMask];
+}
+
+inline void SearchLabels::setDistance(int cell, int distance) {
+    if (narrow) {
+        narrowDistances.begin()[cell] = static_cast<uint16_t>(distance);
+    } else {
+        wideDistances.begin()[cell] = distance;
+    }
+}
+
+inline void SearchLabels::setRoot(int cell) {
+    unsigned char& bits = touch(cell);
+    bits = static_cast<unsigned char>((bits & settledBit) | rootBit | reachedBit);
+    setDistance(cell, 0);
+}
+
+inline void SearchLabels::label(int cell, int distance, int parentDir) {
+    unsigned char& bits = touch(cell);
+    bits = static_cast<unsigned char>((bits & settledBit) | reachedBit | parentDir);
+    setDistance(cell, distance);
+}
+
+inline void SearchLabels::settle(int cell) {
+    touch(cell) |= settledBit;
+}
+
+#endif // SEARCH_LABELS_H
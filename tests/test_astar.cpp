@@ -0,0 +1,31 @@
+// test_astar.cpp
+// A* and bidirectional A*, with the built-in and caller-supplied
+// heuristics, against plain bidirectional search.
+#include "test_util.h"
+
+int main() {
+    beginTests();
+    std::mt19937 rng(7);
+    for (int trial = 0; trial < 60; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        for (int query = 0; query < 20; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end, SearchMode::Bidirectional);
+            int expected = plain.empty() ? -1 : pathLength(plain);
+            CHECK(expected == referenceDistance(maze, start, end));
+
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::AStar), start, end, expected));
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::BidirectionalAStar), start, end,
+                                 expected));
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::AStar, ZeroHeuristic()), start,
+                                 end, expected));
+            CHECK(isPathOfLength(maze,
+                                 solver.findShortestPath(start, end, SearchMode::BidirectionalAStar,
+                                                         ManhattanHeuristic()),
+                                 start, end, expected));
+        }
+    }
+    return finishTests("astar");
+}
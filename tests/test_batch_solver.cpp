@@ -0,0 +1,112 @@
+// test_batch_solver.cpp
+// Batches come back in query order with the same path lengths as one
+// solver answering them in turn, for every supported mode, queue kind and
+// thread count, including with more threads than cores racing over many
+// cheap queries and with plain threads sharing one solver.
+#include "batch_solver.h"
+#include "test_util.h"
+#include <thread>
+#include <vector>
+
+static const SearchMode modes[3] = {SearchMode::Bidirectional, SearchMode::AStar, SearchMode::BidirectionalAStar};
+static const QueueKind kinds[4] = {QueueKind::BinaryHeap, QueueKind::Bucket, QueueKind::Fifo, QueueKind::Radix};
+
+// Many more threads than queries are worth, on a small maze, so workers
+// finish their ranges almost at once and steal from each other constantly.
+static void checkContention(std::mt19937& rng) {
+    Grid<char> maze = randomMaze(12, 9, 25, rng);
+    MyVector<BatchSolver::Query> queries;
+    for (int i = 0; i < 3000; ++i) {
+        queries.push_back({randomOpenCell(maze, rng), randomOpenCell(maze, rng)});
+    }
+    dekstra solver(maze);
+    MyVector<int> expected(queries.size(), -1);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        MyVector<std::pair<int, int>> path = solver.findShortestPath(queries[i].first, queries[i].second);
+        expected[i] = path.empty() ? -1 : pathLength(path);
+    }
+
+    BatchSolver batch(maze, 16);
+    for (int round = 0; round < 10; ++round) {
+        batch.setSearchMode(modes[round % 3]);
+        batch.setQueueKind(kinds[round % 4]);
+        MyVector<MyVector<std::pair<int, int>>> paths = batch.solve(queries);
+        bool ok = paths.size() == queries.size();
+        for (size_t i = 0; ok && i < queries.size(); ++i) {
+            ok = isPathOfLength(maze, paths[i], queries[i].first, queries[i].second, expected[i]);
+        }
+        CHECK(ok);
+    }
+
+    // Threads with a workspace each query the same solver directly
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(8, 0);
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            SearchWorkspace workspace = solver.makeWorkspace();
+            for (size_t i = t; i < queries.size(); i += 3) {
+                MyVector<std::pair<int, int>> path = solver.findShortestPath(
+                    workspace, queries[i].first, queries[i].second, modes[(i + t) % 3], kinds[(i + t) % 4]);
+                if (!isPathOfLength(maze, path, queries[i].first, queries[i].second, expected[i])) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        CHECK(count == 0);
+    }
+    SearchWorkspace workspace = solver.makeWorkspace();
+    CHECK(solver.findShortestPath(workspace, queries[0].first, queries[0].second, SearchMode::JumpPoint, QueueKind::Bucket)
+              .empty());
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(14);
+    for (int trial = 0; trial < 12; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        MyVector<BatchSolver::Query> queries;
+        for (int i = 0; i < 200; ++i) {
+            queries.push_back({randomOpenCell(maze, rng), randomOpenCell(maze, rng)});
+        }
+        queries.push_back({queries[0].first, queries[0].first});
+        queries.push_back({{-1, 0}, queries[0].second});
+        queries.push_back({queries[0].first, {0, maze.height()}});
+
+        dekstra solver(maze);
+        MyVector<int> expected(queries.size(), -1);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            MyVector<std::pair<int, int>> path = solver.findShortestPath(queries[i].first, queries[i].second);
+            expected[i] = path.empty() ? -1 : pathLength(path);
+        }
+
+        BatchSolver batch(maze, 1 + trial % 4);
+        CHECK(batch.threadCount() == static_cast<unsigned>(1 + trial % 4));
+        if (trial % 2 == 1) {
+            batch.buildLandmarks(4);
+        }
+        for (SearchMode mode : modes) {
+            batch.setSearchMode(mode);
+            CHECK(batch.getSearchMode() == mode);
+            for (QueueKind kind : kinds) {
+                batch.setQueueKind(kind);
+                MyVector<MyVector<std::pair<int, int>>> paths = batch.solve(queries);
+                CHECK(paths.size() == queries.size());
+                for (size_t i = 0; i < queries.size() && i < paths.size(); ++i) {
+                    CHECK(isPathOfLength(maze, paths[i], queries[i].first, queries[i].second, expected[i]));
+                }
+            }
+        }
+
+        // Unsupported modes are refused and leave the current one in place
+        batch.setSearchMode(SearchMode::JumpPoint);
+        CHECK(batch.getSearchMode() == SearchMode::BidirectionalAStar);
+        CHECK(batch.solve(nullptr, 0).empty());
+    }
+    checkContention(rng);
+    return finishTests("batch_solver");
+}
@@ -0,0 +1,42 @@
+// test_bidirectional.cpp
+// Plain bidirectional search against a reference breadth-first search,
+// including terminal cells, repeated queries on one solver and rejected
+// endpoints.
+#include "test_util.h"
+
+int main() {
+    beginTests();
+    std::mt19937 rng(6);
+    for (int trial = 0; trial < 60; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        for (int query = 0; query < 20; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = query == 0 ? start : randomOpenCell(maze, rng);
+            int expected = referenceDistance(maze, start, end);
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end), start, end, expected));
+            // Same answer the second time round, from reused labels
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end), start, end, expected));
+        }
+        // Terminals only connect to plain path cells
+        for (size_t cell = 0; cell < maze.size(); ++cell) {
+            if (maze[cell] == 'I' || maze[cell] == 'O') {
+                std::pair<int, int> terminal = {maze.xOf(cell), maze.yOf(cell)};
+                std::pair<int, int> start = randomOpenCell(maze, rng);
+                int expected = referenceDistance(maze, start, terminal);
+                CHECK(isPathOfLength(maze, solver.findShortestPath(start, terminal), start, terminal, expected));
+            }
+        }
+
+        std::pair<int, int> open = randomOpenCell(maze, rng);
+        CHECK(solver.findShortestPath(open, {-1, 0}).empty());
+        CHECK(solver.findShortestPath({maze.width(), 0}, open).empty());
+        for (size_t cell = 0; cell < maze.size(); ++cell) {
+            if (maze[cell] == '+') {
+                CHECK(solver.findShortestPath(open, {maze.xOf(cell), maze.yOf(cell)}).empty());
+                break;
+            }
+        }
+    }
+    return finishTests("bidirectional");
+}
@@ -0,0 +1,114 @@
+// test_components.cpp
+// Component labels kept through edits describe the same partition as a
+// fresh build, so connected() agrees with breadth-first search, also when
+// one batch of edits both splits and merges components.
+#include "test_util.h"
+
+static bool samePartition(dekstra& solver, const Grid<char>& maze) {
+    dekstra fresh(maze);
+    bool same = solver.getComponents().componentCount() == fresh.getComponents().componentCount();
+    for (size_t a = 0; a < maze.size(); ++a) {
+        for (size_t b = a + 1; b < maze.size(); ++b) {
+            same = same && solver.getComponents().connected(static_cast<int>(a), static_cast<int>(b)) ==
+                               fresh.getComponents().connected(static_cast<int>(a), static_cast<int>(b));
+        }
+    }
+    return same;
+}
+
+// One edit that cuts a corridor in two and, in the same batch, joins one
+// half to another component; then one that joins both halves back while
+// closing another cell.
+static void checkSplitAndMerge() {
+    const char* rows[] = {"+++++++++", "+-------+", "+++++++++", "+-------+", "+++++++++"};
+    Grid<char> maze = fromRows(rows, 5);
+    dekstra solver(maze);
+    CHECK(solver.getComponents().componentCount() == 2);
+
+    maze(4, 1) = '+';
+    maze(2, 2) = '-';
+    solver.updateCells({{4, 1}, {2, 2}});
+    CHECK(solver.getComponents().componentCount() == 2);
+    CHECK(solver.componentOf({1, 1}) == solver.componentOf({7, 3}));
+    CHECK(solver.componentOf({1, 1}) != solver.componentOf({7, 1}));
+    CHECK(solver.componentOf({4, 1}) == -1);
+    CHECK(samePartition(solver, maze));
+
+    maze(6, 2) = '-';
+    maze(7, 3) = '+';
+    solver.updateCells({{6, 2}, {7, 3}});
+    CHECK(solver.getComponents().componentCount() == 1);
+    CHECK(solver.componentOf({1, 1}) == solver.componentOf({7, 1}));
+    CHECK(solver.componentOf({1, 3}) == solver.componentOf({7, 1}));
+    CHECK(solver.componentOf({7, 3}) == -1);
+    CHECK(samePartition(solver, maze));
+}
+
+// Batches that open and close cells at once, all over the maze.
+static void checkMixedBatches(std::mt19937& rng) {
+    for (int trial = 0; trial < 20; ++trial) {
+        Grid<char> maze = randomMaze(16, 16, 40, rng);
+        dekstra solver(maze);
+        for (int round = 0; round < 20; ++round) {
+            MyVector<std::pair<int, int>> changed;
+            for (int i = 0; i < 6; ++i) {
+                std::pair<int, int> cell = {static_cast<int>(rng() % maze.width()), static_cast<int>(rng() % maze.height())};
+                char& value = maze(cell.first, cell.second);
+                if (value == '-' || value == '+') {
+                    value = value == '-' ? '+' : '-';
+                    changed.push_back(cell);
+                }
+            }
+            solver.updateCells(changed);
+            CHECK(samePartition(solver, maze));
+        }
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(22);
+    checkSplitAndMerge();
+    checkMixedBatches(rng);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = trial % 2 == 0 ? testMaze(trial, rng) : randomMaze(40, 40, 35 + trial % 20, rng);
+        dekstra solver(maze);
+        for (int round = 0; round < 30; ++round) {
+            // Batches of edits, from single cells up to short wall runs that
+            // cut regions in two
+            MyVector<std::pair<int, int>> changed;
+            int length = 1 + static_cast<int>(rng() % 6);
+            std::pair<int, int> cell = {static_cast<int>(rng() % maze.width()), static_cast<int>(rng() % maze.height())};
+            char value = rng() % 2 == 0 ? '+' : '-';
+            bool across = rng() % 2 == 0;
+            for (int i = 0; i < length && maze.inBounds(cell.first, cell.second); ++i) {
+                if (maze(cell.first, cell.second) == '-' || maze(cell.first, cell.second) == '+') {
+                    maze(cell.first, cell.second) = value;
+                    changed.push_back(cell);
+                }
+                (across ? cell.first : cell.second) += 1;
+            }
+            solver.updateCells(changed);
+
+            dekstra fresh(maze);
+            CHECK(solver.getComponents().componentCount() == fresh.getComponents().componentCount());
+            for (int query = 0; query < 20; ++query) {
+                std::pair<int, int> a = {static_cast<int>(rng() % maze.width()), static_cast<int>(rng() % maze.height())};
+                std::pair<int, int> b = {static_cast<int>(rng() % maze.width()), static_cast<int>(rng() % maze.height())};
+                bool hasMoves = fresh.getMoves()(a.first, a.second) != 0;
+                CHECK((solver.componentOf(a) == -1) == !hasMoves);
+                bool joined = isOpenCell(maze(a.first, a.second)) && isOpenCell(maze(b.first, b.second)) &&
+                              referenceDistance(maze, a, b) >= 0;
+                int ia = static_cast<int>(maze.index(a.first, a.second));
+                int ib = static_cast<int>(maze.index(b.first, b.second));
+                if (isOpenCell(maze(a.first, a.second)) && isOpenCell(maze(b.first, b.second))) {
+                    CHECK(solver.getComponents().connected(ia, ib) == joined);
+                    CHECK((solver.findShortestPath(a, b).size() > 0) == joined);
+                }
+            }
+        }
+        CHECK(solver.componentOf({-1, 0}) == -1);
+        CHECK(solver.componentOf({0, maze.height()}) == -1);
+    }
+    return finishTests("components");
+}
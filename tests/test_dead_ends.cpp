@@ -0,0 +1,84 @@
+// test_dead_ends.cpp
+// Dead-end filling: every mode still finds shortest paths between protected
+// cells, the masks kept through protectCell() and edits match a fresh pass
+// with the same protected cells, and endpoints in a cut branch are refused.
+#include "test_util.h"
+
+static const SearchMode modes[8] = {SearchMode::Bidirectional,  SearchMode::AStar,
+                                    SearchMode::BidirectionalAStar, SearchMode::JumpPoint,
+                                    SearchMode::ParallelBidirectional, SearchMode::LevelSynchronous,
+                                    SearchMode::BreadthFirst,   SearchMode::JunctionGraph};
+
+int main() {
+    beginTests();
+    std::mt19937 rng(24);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        solver.fillDeadEnds();
+        MyVector<std::pair<int, int>> protectedCells;
+        for (int query = 0; query < 20; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            solver.protectCell(start);
+            solver.protectCell(end);
+            protectedCells.push_back(start);
+            protectedCells.push_back(end);
+            CHECK(!solver.isPruned(start) && !solver.isPruned(end));
+
+            dekstra fresh(maze);
+            for (size_t i = 0; i < protectedCells.size(); ++i) {
+                fresh.protectCell(protectedCells[i]);
+            }
+            fresh.fillDeadEnds();
+            bool same = true;
+            for (size_t cell = 0; cell < maze.size(); ++cell) {
+                same = same && fresh.getMoves()[cell] == solver.getMoves()[cell];
+            }
+            CHECK(same);
+            // Protecting a cell again changes nothing
+            solver.protectCell(start);
+            solver.protectCell(end);
+            for (size_t cell = 0; cell < maze.size(); ++cell) {
+                same = same && fresh.getMoves()[cell] == solver.getMoves()[cell];
+            }
+            CHECK(same);
+            CHECK(fresh.getComponents().componentCount() == solver.getComponents().componentCount());
+
+            int expected = isOpenCell(maze(start.first, start.second)) && isOpenCell(maze(end.first, end.second))
+                               ? referenceDistance(maze, start, end)
+                               : -1;
+            for (SearchMode mode : modes) {
+                CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, mode), start, end, expected));
+            }
+            CHECK(isPathOfLength(maze, solver.findIncrementalPath(start, end), start, end, expected));
+
+            // Cut cells cannot be endpoints until protected
+            for (size_t cell = 0; cell < maze.size(); ++cell) {
+                std::pair<int, int> at = {maze.xOf(cell), maze.yOf(cell)};
+                if (solver.isPruned(at) && at != start) {
+                    CHECK(solver.findShortestPath(start, at).empty());
+                    break;
+                }
+            }
+
+            if (query % 5 == 4) {
+                MyVector<std::pair<int, int>> changed;
+                std::pair<int, int> cell = {static_cast<int>(rng() % maze.width()),
+                                            static_cast<int>(rng() % maze.height())};
+                char& value = maze(cell.first, cell.second);
+                if (value == '-' || value == '+') {
+                    value = value == '-' ? '+' : '-';
+                    changed.push_back(cell);
+                }
+                solver.updateCells(changed);
+            }
+        }
+        solver.clearDeadEnds();
+        std::pair<int, int> start = randomOpenCell(maze, rng);
+        std::pair<int, int> end = randomOpenCell(maze, rng);
+        CHECK(!solver.isPruned(start));
+        CHECK(isPathOfLength(maze, solver.findShortestPath(start, end), start, end, referenceDistance(maze, start, end)));
+    }
+    return finishTests("dead_ends");
+}
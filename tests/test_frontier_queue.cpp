@@ -0,0 +1,78 @@
+// test_frontier_queue.cpp
+// Every queue backend pops in key order, and the solver finds shortest
+// paths with each of them.
+#include "frontier_queue.h"
+#include "test_util.h"
+#include <algorithm>
+#include <vector>
+
+static const QueueKind kinds[4] = {QueueKind::BinaryHeap, QueueKind::Bucket, QueueKind::Fifo, QueueKind::Radix};
+
+// Pushes keys the way a search does: never below the last popped key, and
+// in non-decreasing order when `sorted` (the FIFO restriction).
+static void checkPopOrder(QueueKind kind, bool sorted, std::mt19937& rng) {
+    FrontierQueue queue(kind);
+    std::vector<int> pushed;
+    std::vector<int> popped;
+    int lastPushed = 0;
+    int lastPopped = 0;
+    queue.push(0, 0);
+    pushed.push_back(0);
+    while (!queue.empty()) {
+        CHECK(queue.topKey() >= lastPopped);
+        int key;
+        int cell = queue.pop(key);
+        CHECK(key >= lastPopped);
+        CHECK(cell == key * 7 % 1000);
+        lastPopped = key;
+        popped.push_back(key);
+        int children = pushed.size() < 5000 ? static_cast<int>(rng() % 3) : 0;
+        for (int i = 0; i < children; ++i) {
+            int next = sorted ? lastPushed + static_cast<int>(rng() % 2) : key + static_cast<int>(rng() % 40);
+            lastPushed = std::max(lastPushed, next);
+            queue.push(next, next * 7 % 1000);
+            pushed.push_back(next);
+        }
+        if (queue.empty() && pushed.size() < 5000) {
+            queue.push(lastPushed, lastPushed * 7 % 1000);
+            pushed.push_back(lastPushed);
+        }
+    }
+    std::sort(pushed.begin(), pushed.end());
+    CHECK(pushed == popped);
+    CHECK(queue.size() == 0);
+    CHECK(queue.topKey() == FrontierQueue::emptyKey);
+    // An emptied queue keeps reporting the sentinel until it is refilled
+    queue.push(lastPopped + 3, 1);
+    CHECK(queue.topKey() == lastPopped + 3);
+    queue.pop(lastPopped);
+    CHECK(queue.topKey() == FrontierQueue::emptyKey);
+    queue.clear();
+    CHECK(queue.topKey() == FrontierQueue::emptyKey);
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(5);
+    for (QueueKind kind : kinds) {
+        checkPopOrder(kind, true, rng);
+        if (kind != QueueKind::Fifo) {
+            checkPopOrder(kind, false, rng);
+        }
+    }
+
+    for (int trial = 0; trial < 30; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        for (int query = 0; query < 10; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            int expected = referenceDistance(maze, start, end);
+            for (QueueKind kind : kinds) {
+                solver.setQueueKind(kind);
+                CHECK(isPathOfLength(maze, solver.findShortestPath(start, end), start, end, expected));
+            }
+        }
+    }
+    return finishTests("frontier_queue");
+}
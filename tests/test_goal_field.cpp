@@ -0,0 +1,59 @@
+// test_goal_field.cpp
+// Goal distance fields: distances match breadth-first search, every next
+// step gets one closer, and the field follows goal changes and edits.
+#include "test_util.h"
+
+static void checkField(const Grid<char>& maze, dekstra& solver, const std::pair<int, int>& goal, std::mt19937& rng) {
+    for (int query = 0; query < 20; ++query) {
+        std::pair<int, int> from = randomOpenCell(maze, rng);
+        int expected = referenceDistance(maze, from, goal);
+        CHECK(solver.distanceToGoal(from) == expected);
+        std::pair<int, int> next = solver.nextStepToGoal(from);
+        if (expected < 0) {
+            CHECK(next == std::make_pair(-1, -1));
+        } else if (expected == 0) {
+            CHECK(next == from);
+        } else {
+            CHECK(canStep(maze, from, next));
+            CHECK(solver.distanceToGoal(next) == expected - 1);
+        }
+        CHECK(isPathOfLength(maze, solver.pathToGoal(from), from, goal, expected));
+    }
+    CHECK(solver.pathToGoal({-1, -1}).empty());
+    CHECK(solver.pathToGoal({maze.width(), 0}).empty());
+    MyVector<std::pair<int, int>> here = solver.pathToGoal(goal);
+    CHECK(here.size() == 1 && here[0] == goal);
+    for (size_t cell = 0; cell < maze.size(); ++cell) {
+        if (maze[cell] == '+') {
+            CHECK(solver.pathToGoal({maze.xOf(cell), maze.yOf(cell)}).empty());
+            break;
+        }
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(11);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        std::pair<int, int> goal = randomOpenCell(maze, rng);
+        solver.setGoal(goal);
+        CHECK(solver.getGoal() == goal);
+        checkField(maze, solver, goal, rng);
+
+        goal = randomOpenCell(maze, rng);
+        solver.setGoal(goal);
+        checkField(maze, solver, goal, rng);
+
+        for (int edit = 0; edit < 8; ++edit) {
+            std::pair<int, int> cell = randomOpenCell(maze, rng);
+            if (cell != goal) {
+                maze(cell.first, cell.second) = '+';
+            }
+        }
+        solver.onMazeChanged();
+        checkField(maze, solver, goal, rng);
+    }
+    return finishTests("goal_field");
+}
@@ -0,0 +1,90 @@
+// test_grid.cpp
+// Row-major Grid storage, the generator's output in it, and solver routes
+// read back through it.
+#include "test_util.h"
+
+static void checkGridLayout() {
+    Grid<int> empty;
+    CHECK(empty.width() == 0 && empty.height() == 0 && empty.size() == 0);
+
+    Grid<int> grid(7, 5, -3);
+    CHECK(grid.width() == 7 && grid.height() == 5 && grid.size() == 35);
+    for (size_t cell = 0; cell < grid.size(); ++cell) {
+        CHECK(grid[cell] == -3);
+    }
+    for (int y = 0; y < grid.height(); ++y) {
+        for (int x = 0; x < grid.width(); ++x) {
+            size_t cell = grid.index(x, y);
+            CHECK(cell == static_cast<size_t>(y) * 7 + x);
+            CHECK(grid.xOf(cell) == x && grid.yOf(cell) == y);
+            grid(x, y) = static_cast<int>(cell);
+        }
+    }
+    // (x, y) and flat indexing alias the same row-major storage
+    for (size_t cell = 0; cell < grid.size(); ++cell) {
+        CHECK(grid[cell] == static_cast<int>(cell));
+        CHECK(grid.data()[cell] == static_cast<int>(cell));
+    }
+    CHECK(&grid(6, 0) + 1 == &grid(0, 1));
+
+    CHECK(grid.inBounds(0, 0) && grid.inBounds(6, 4));
+    CHECK(!grid.inBounds(-1, 0) && !grid.inBounds(0, -1));
+    CHECK(!grid.inBounds(7, 0) && !grid.inBounds(0, 5));
+
+    grid.fill(9);
+    for (size_t cell = 0; cell < grid.size(); ++cell) {
+        CHECK(grid[cell] == 9);
+    }
+
+    Grid<int> copy = grid;
+    copy(3, 2) = 1;
+    CHECK(grid(3, 2) == 9);
+}
+
+static void checkGeneratedMaze(std::mt19937& rng) {
+    for (int trial = 0; trial < 10; ++trial) {
+        int width = 9 + 2 * static_cast<int>(rng() % 20);
+        int height = 9 + 2 * static_cast<int>(rng() % 20);
+        MazeGenerator generator(width, height);
+        std::srand(static_cast<unsigned>(rng()));
+        generator.generate();
+        const Grid<char>& maze = generator.getMaze();
+        CHECK(maze.width() == width && maze.height() == height);
+        std::pair<int, int> start = generator.getStartPoint();
+        std::pair<int, int> end = generator.getEndPoint();
+        CHECK(maze.inBounds(start.first, start.second) && maze(start.first, start.second) == 'I');
+        CHECK(maze.inBounds(end.first, end.second) && maze(end.first, end.second) == 'O');
+        for (size_t cell = 0; cell < maze.size(); ++cell) {
+            char c = maze[cell];
+            CHECK(c == '+' || isOpenCell(c));
+        }
+    }
+}
+
+// Routes read back through the grids are shortest chains of open cells,
+// and none is reported where the reference search finds none.
+static void checkSolverRoutes(std::mt19937& rng) {
+    for (int trial = 0; trial < 30; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        for (int query = 0; query < 5; ++query) {
+            dekstra solver(maze);
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            int expected = referenceDistance(maze, start, end);
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end), start, end, expected));
+        }
+        dekstra solver(maze);
+        std::pair<int, int> open = randomOpenCell(maze, rng);
+        CHECK(solver.findShortestPath(open, {-1, 0}).empty());
+        CHECK(solver.findShortestPath({maze.width(), 0}, open).empty());
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(1);
+    checkGridLayout();
+    checkGeneratedMaze(rng);
+    checkSolverRoutes(rng);
+    return finishTests("grid");
+}
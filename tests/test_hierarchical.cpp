@@ -0,0 +1,109 @@
+// test_hierarchical.cpp
+// HPA*: routes are valid and never shorter than the true distance, exist
+// exactly when a route does, and after edits match a hierarchy built from
+// scratch on the edited maze, with and without dead-end filling. Border
+// runs are split next to touching terminals. Queries before
+// buildHierarchy() are refused.
+#include "test_util.h"
+
+static void prepare(dekstra& solver, int clusterSize, bool exact, bool deadEnds,
+                    const MyVector<std::pair<int, int>>& protectedCells) {
+    for (size_t i = 0; i < protectedCells.size(); ++i) {
+        solver.protectCell(protectedCells[i]);
+    }
+    if (deadEnds) {
+        solver.fillDeadEnds();
+    }
+    solver.buildHierarchy(clusterSize);
+    solver.setExactRefinement(exact);
+}
+
+// A border run through touching 'I' and 'O' cells: the terminal at one
+// end leaves its cluster only through its own crossing, so the run must be
+// split there for it to get an entrance. Checked across an east border and
+// the same layout transposed across a south one.
+static void checkTerminalRuns() {
+    const char* east[] = {"++++++++", "+++I-+++", "+--O-+++", "++++++++"};
+    const char* south[] = {"++++", "++-+", "++-+", "+IO+", "+--+", "++++", "++++", "++++"};
+    struct Case {
+        Grid<char> maze;
+        std::pair<int, int> start;
+        std::pair<int, int> terminal;
+    } cases[2] = {{fromRows(east, 4), {1, 2}, {3, 1}}, {fromRows(south, 8), {2, 1}, {1, 3}}};
+    for (const Case& test : cases) {
+        for (bool exact : {false, true}) {
+            dekstra solver(test.maze);
+            solver.buildHierarchy(4);
+            solver.setExactRefinement(exact);
+            int expected = referenceDistance(test.maze, test.start, test.terminal);
+            CHECK(expected == 5);
+            MyVector<std::pair<int, int>> path =
+                solver.findShortestPath(test.start, test.terminal, SearchMode::Hierarchical);
+            CHECK(isPathOfLength(test.maze, path, test.start, test.terminal, expected));
+            path = solver.findShortestPath(test.terminal, test.start, SearchMode::Hierarchical);
+            CHECK(isPathOfLength(test.maze, path, test.terminal, test.start, expected));
+        }
+    }
+}
+
+int main() {
+    beginTests();
+    checkTerminalRuns();
+    std::mt19937 rng(25);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        int clusterSize = 2 + static_cast<int>(rng() % 12);
+        bool exact = trial % 2 == 0;
+        bool deadEnds = trial % 4 >= 2;
+
+        dekstra solver(maze);
+        std::pair<int, int> open = randomOpenCell(maze, rng);
+        CHECK(solver.findShortestPath(open, open, SearchMode::Hierarchical).empty());
+
+        MyVector<std::pair<int, int>> protectedCells;
+        prepare(solver, clusterSize, exact, deadEnds, protectedCells);
+        for (int round = 0; round < 6; ++round) {
+            for (int query = 0; query < 10; ++query) {
+                std::pair<int, int> start = randomOpenCell(maze, rng);
+                std::pair<int, int> end = randomOpenCell(maze, rng);
+                solver.protectCell(start);
+                solver.protectCell(end);
+                protectedCells.push_back(start);
+                protectedCells.push_back(end);
+                int shortest = referenceDistance(maze, start, end);
+                MyVector<std::pair<int, int>> path = solver.findShortestPath(start, end, SearchMode::Hierarchical);
+                CHECK(path.empty() == (shortest < 0));
+                if (!path.empty()) {
+                    CHECK(pathLength(path) >= shortest);
+                    CHECK(isPathOfLength(maze, path, start, end, pathLength(path)));
+                }
+            }
+
+            // Incremental cluster rebuilds give what a fresh build gives
+            dekstra fresh(maze);
+            prepare(fresh, clusterSize, exact, deadEnds, protectedCells);
+            for (int query = 0; query < 10; ++query) {
+                std::pair<int, int> start = protectedCells[rng() % protectedCells.size()];
+                std::pair<int, int> end = protectedCells[rng() % protectedCells.size()];
+                CHECK(solver.findShortestPath(start, end, SearchMode::Hierarchical).size() ==
+                      fresh.findShortestPath(start, end, SearchMode::Hierarchical).size());
+            }
+
+            MyVector<std::pair<int, int>> changed;
+            for (int edit = 0; edit < 4; ++edit) {
+                std::pair<int, int> cell = {static_cast<int>(rng() % maze.width()),
+                                            static_cast<int>(rng() % maze.height())};
+                char& value = maze(cell.first, cell.second);
+                if (value == '-' || value == '+') {
+                    value = value == '-' ? '+' : '-';
+                    changed.push_back(cell);
+                }
+            }
+            solver.updateCells(changed);
+        }
+
+        solver.clearHierarchy();
+        CHECK(solver.findShortestPath(open, open, SearchMode::Hierarchical).empty());
+    }
+    return finishTests("hierarchical");
+}
@@ -0,0 +1,62 @@
+// test_incremental.cpp
+// D* Lite after edits: masks match a solver built on the edited maze, and
+// every repaired path matches a reference breadth-first search, while the
+// start walks along the path as a moving agent would.
+#include "test_util.h"
+
+static void toggle(Grid<char>& maze, MyVector<std::pair<int, int>>& changed, std::mt19937& rng,
+                   const std::pair<int, int>& keepA, const std::pair<int, int>& keepB) {
+    std::pair<int, int> cell = {static_cast<int>(rng() % maze.width()), static_cast<int>(rng() % maze.height())};
+    if (cell == keepA || cell == keepB) {
+        return;
+    }
+    char& value = maze(cell.first, cell.second);
+    if (value == '-' || value == '+') {
+        value = value == '-' ? '+' : '-';
+        changed.push_back(cell);
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(21);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        std::pair<int, int> start = randomOpenCell(maze, rng);
+        std::pair<int, int> end = randomOpenCell(maze, rng);
+        for (int step = 0; step < 25; ++step) {
+            int expected = referenceDistance(maze, start, end);
+            MyVector<std::pair<int, int>> path = solver.findIncrementalPath(start, end);
+            CHECK(isPathOfLength(maze, path, start, end, expected));
+
+            MyVector<std::pair<int, int>> changed;
+            int edits = 1 + static_cast<int>(rng() % 4);
+            for (int i = 0; i < edits; ++i) {
+                toggle(maze, changed, rng, start, end);
+            }
+            // An edit list may name cells twice or lie outside the maze
+            if (!changed.empty()) {
+                changed.push_back(changed[0]);
+            }
+            changed.push_back({-1, maze.height()});
+            solver.updateCells(changed);
+
+            dekstra fresh(maze);
+            bool same = true;
+            for (size_t cell = 0; cell < maze.size(); ++cell) {
+                same = same && fresh.getMoves()[cell] == solver.getMoves()[cell];
+            }
+            CHECK(same);
+            CHECK(solver.getExits().size() == fresh.getExits().size());
+
+            if (path.size() > 2) {
+                start = path[1 + rng() % 2];
+            }
+            if (rng() % 8 == 0) {
+                end = randomOpenCell(maze, rng); // a new goal plans from scratch
+            }
+        }
+    }
+    return finishTests("incremental");
+}
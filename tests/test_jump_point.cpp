@@ -0,0 +1,40 @@
+// test_jump_point.cpp
+// Jump point search, with and without the JPS+ jump table, against plain
+// bidirectional search, also after the maze is edited.
+#include "test_util.h"
+
+static void checkQueries(const Grid<char>& maze, dekstra& solver, std::mt19937& rng) {
+    for (int query = 0; query < 20; ++query) {
+        std::pair<int, int> start = randomOpenCell(maze, rng);
+        std::pair<int, int> end = randomOpenCell(maze, rng);
+        MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end, SearchMode::Bidirectional);
+        int expected = plain.empty() ? -1 : pathLength(plain);
+        CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::JumpPoint), start, end, expected));
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(9);
+    for (int trial = 0; trial < 60; ++trial) {
+        // Open grids are where jump points matter; mazes still have to work
+        Grid<char> maze = trial % 2 == 0 ? randomMaze(10 + static_cast<int>(rng() % 60),
+                                                      10 + static_cast<int>(rng() % 60),
+                                                      static_cast<int>(rng() % 35), rng)
+                                         : testMaze(trial, rng);
+        dekstra solver(maze);
+        checkQueries(maze, solver, rng);
+        solver.buildJumpTable();
+        checkQueries(maze, solver, rng);
+
+        for (int edit = 0; edit < 10; ++edit) {
+            std::pair<int, int> cell = randomOpenCell(maze, rng);
+            maze(cell.first, cell.second) = '+';
+        }
+        solver.onMazeChanged();
+        checkQueries(maze, solver, rng);
+        solver.clearJumpTable();
+        checkQueries(maze, solver, rng);
+    }
+    return finishTests("jump_point");
+}
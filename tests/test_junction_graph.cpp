@@ -0,0 +1,50 @@
+// test_junction_graph.cpp
+// Searches on the corridor-compressed graph match plain bidirectional
+// search, including endpoints in the middle of corridors, and stay correct
+// as the maze is edited.
+#include "test_util.h"
+
+int main() {
+    beginTests();
+    std::mt19937 rng(23);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        if (trial % 2 == 0) {
+            solver.buildJunctionGraph(); // otherwise built by the first query
+        }
+        for (int round = 0; round < 6; ++round) {
+            for (int query = 0; query < 15; ++query) {
+                std::pair<int, int> start = randomOpenCell(maze, rng);
+                std::pair<int, int> end = query == 0 ? start : randomOpenCell(maze, rng);
+                MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end, SearchMode::Bidirectional);
+                int expected = plain.empty() ? -1 : pathLength(plain);
+                CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::JunctionGraph), start, end,
+                                     expected));
+            }
+            for (size_t i = 0; i < solver.getExits().size(); ++i) {
+                std::pair<int, int> start = randomOpenCell(maze, rng);
+                std::pair<int, int> exit = solver.getExits()[i];
+                CHECK(isPathOfLength(maze, solver.findShortestPath(start, exit, SearchMode::JunctionGraph), start, exit,
+                                     referenceDistance(maze, start, exit)));
+            }
+
+            MyVector<std::pair<int, int>> changed;
+            for (int edit = 0; edit < 3; ++edit) {
+                std::pair<int, int> cell = {static_cast<int>(rng() % maze.width()),
+                                            static_cast<int>(rng() % maze.height())};
+                char& value = maze(cell.first, cell.second);
+                if (value == '-' || value == '+') {
+                    value = value == '-' ? '+' : '-';
+                    changed.push_back(cell);
+                }
+            }
+            if (round % 2 == 0) {
+                solver.updateCells(changed);
+            } else {
+                solver.onMazeChanged();
+            }
+        }
+    }
+    return finishTests("junction_graph");
+}
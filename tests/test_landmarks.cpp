@@ -0,0 +1,111 @@
+// test_landmarks.cpp
+// ALT heuristics: bounds never exceed true distances, A* with landmarks
+// matches plain bidirectional search, and saved tables load back only for
+// the maze they were built on.
+#include "test_util.h"
+#include <cstring>
+#include <sstream>
+#include <string>
+
+// Serves a string without seek support, like a pipe.
+class PipeBuffer : public std::streambuf {
+public:
+    explicit PipeBuffer(const std::string& text) : text(text) {
+        char* begin = &this->text[0];
+        setg(begin, begin, begin + this->text.size());
+    }
+
+private:
+    std::string text;
+};
+
+static void setWord(std::string& bytes, size_t offset, int32_t value) {
+    std::memcpy(&bytes[offset], &value, sizeof(value));
+}
+
+// Loads bytes both from a seekable stream and from a pipe.
+static bool loads(dekstra& solver, const std::string& bytes, bool seekable) {
+    if (seekable) {
+        std::stringstream stream(bytes);
+        return solver.loadLandmarks(stream);
+    }
+    PipeBuffer buffer(bytes);
+    std::istream stream(&buffer);
+    return solver.loadLandmarks(stream);
+}
+
+// Headers that do not fit the maze or the data behind them are rejected
+// before the tables are allocated.
+static void checkCorruptTables(const Grid<char>& maze, const dekstra& solver) {
+    std::stringstream stream;
+    CHECK(solver.saveLandmarks(stream));
+    std::string bytes = stream.str();
+    // magic, version, then width, height, checksum, count
+    const size_t countOffset = 4 + 4 + 12;
+    const size_t landmarkOffset = countOffset + 4;
+    for (bool seekable : {true, false}) {
+        dekstra copy(maze);
+        CHECK(loads(copy, bytes, seekable));
+        CHECK(copy.getLandmarks().landmarkCount() == solver.getLandmarks().landmarkCount());
+
+        std::string huge = bytes;
+        setWord(huge, countOffset, 0x7fffffff);
+        dekstra hugeCopy(maze);
+        CHECK(!loads(hugeCopy, huge, seekable));
+        CHECK(hugeCopy.getLandmarks().empty());
+
+        std::string longer = bytes;
+        setWord(longer, countOffset, solver.getLandmarks().landmarkCount() + 1);
+        dekstra longerCopy(maze);
+        CHECK(!loads(longerCopy, longer, seekable));
+
+        std::string truncated = bytes.substr(0, bytes.size() - 4);
+        dekstra truncatedCopy(maze);
+        CHECK(!loads(truncatedCopy, truncated, seekable));
+
+        std::string wall = bytes;
+        setWord(wall, landmarkOffset, static_cast<int32_t>(maze.size()));
+        dekstra wallCopy(maze);
+        CHECK(!loads(wallCopy, wall, seekable));
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(8);
+    for (int trial = 0; trial < 30; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        solver.buildLandmarks(1 + trial % 6);
+        CHECK(!solver.getLandmarks().empty());
+        for (int query = 0; query < 20; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            int expected = referenceDistance(maze, start, end);
+            int startCell = static_cast<int>(maze.index(start.first, start.second));
+            int endCell = static_cast<int>(maze.index(end.first, end.second));
+            if (expected >= 0) {
+                CHECK(solver.getLandmarks().lowerBound(startCell, endCell) <= expected);
+            }
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::AStar), start, end, expected));
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::BidirectionalAStar), start, end,
+                                 expected));
+        }
+
+        std::stringstream stream;
+        CHECK(solver.saveLandmarks(stream));
+        dekstra copy(maze);
+        CHECK(copy.loadLandmarks(stream));
+        CHECK(copy.getLandmarks().landmarkCount() == solver.getLandmarks().landmarkCount());
+
+        checkCorruptTables(maze, solver);
+
+        Grid<char> other = randomMaze(maze.width(), maze.height(), 30, rng);
+        dekstra stranger(other);
+        std::stringstream again;
+        solver.saveLandmarks(again);
+        CHECK(!stranger.loadLandmarks(again));
+        CHECK(stranger.getLandmarks().empty());
+    }
+    return finishTests("landmarks");
+}
@@ -0,0 +1,72 @@
+// test_layout_search.cpp
+// Row-major, tiled and Z-order layouts find paths of the same length as
+// plain bidirectional search, follow rebuilds after edits, and reject
+// endpoints that are closed or out of bounds.
+#include "layout_search.h"
+#include "test_util.h"
+
+static const CellLayout layouts[3] = {CellLayout::RowMajor, CellLayout::Tiled, CellLayout::Morton};
+
+static int openCount(const Grid<char>& maze) {
+    int count = 0;
+    for (size_t cell = 0; cell < maze.size(); ++cell) {
+        count += maze[cell] == '-';
+    }
+    return count;
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(19);
+    for (int trial = 0; trial < 30; ++trial) {
+        Grid<char> maze = trial % 10 == 9 ? randomMaze(150, 130, 30, rng) : testMaze(trial, rng);
+        dekstra solver(maze);
+        for (CellLayout layout : layouts) {
+            LayoutSearch search(solver.getMoves(), layout);
+            CHECK(search.getLayout() == layout);
+            CHECK(search.memoryUsage() >= solver.getMoves().size());
+            for (int round = 0; round < 2; ++round) {
+                for (int query = 0; query < 15; ++query) {
+                    std::pair<int, int> start = randomOpenCell(maze, rng);
+                    std::pair<int, int> end = randomOpenCell(maze, rng);
+                    MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end);
+                    int expected = plain.empty() ? -1 : pathLength(plain);
+                    // A cell without moves counts as closed here
+                    if (solver.getMoves()(start.first, start.second) == 0 ||
+                        solver.getMoves()(end.first, end.second) == 0) {
+                        expected = -1;
+                    }
+                    CHECK(isPathOfLength(maze, search.findPath(start, end), start, end, expected));
+                }
+                std::pair<int, int> open = randomOpenCell(maze, rng);
+                CHECK(search.findPath(open, {maze.width(), 0}).empty());
+                CHECK(search.findPath({0, -1}, open).empty());
+                for (size_t cell = 0; cell < maze.size(); ++cell) {
+                    if (maze[cell] == '+') {
+                        std::pair<int, int> wall = {maze.xOf(cell), maze.yOf(cell)};
+                        CHECK(search.findPath(wall, wall).empty());
+                        CHECK(search.findPath(open, wall).empty());
+                        break;
+                    }
+                }
+
+                // Close three cells and try to open three, keeping small
+                // mazes from running out of open cells over the rounds
+                for (int edit = 0; edit < 3; ++edit) {
+                    std::pair<int, int> cell = randomOpenCell(maze, rng);
+                    if (openCount(maze) > 10) {
+                        maze(cell.first, cell.second) = '+';
+                    }
+                    std::pair<int, int> wall = {static_cast<int>(rng() % maze.width()),
+                                                static_cast<int>(rng() % maze.height())};
+                    if (maze(wall.first, wall.second) == '+') {
+                        maze(wall.first, wall.second) = '-';
+                    }
+                }
+                solver.onMazeChanged();
+                search.rebuild();
+            }
+        }
+    }
+    return finishTests("layout_search");
+}
@@ -0,0 +1,74 @@
+// test_level_bfs.cpp
+// Level-synchronous BFS against plain bidirectional search: through dekstra
+// on mazes below and above the parallel threshold, on the engine directly
+// with several threads forced on small mazes, and with engines of many
+// more threads than cores queried at once so levels finish unevenly and
+// workers keep blocking at the barriers.
+#include "parallel_bfs.h"
+#include "test_util.h"
+#include <thread>
+#include <vector>
+
+static void checkContention(std::mt19937& rng) {
+    Grid<char> maze = randomMaze(40, 30, 25, rng);
+    dekstra solver(maze);
+    MyVector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+    MyVector<int> expected;
+    for (int i = 0; i < 400; ++i) {
+        std::pair<int, int> start = randomOpenCell(maze, rng);
+        std::pair<int, int> end = randomOpenCell(maze, rng);
+        MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end, SearchMode::Bidirectional);
+        queries.push_back({start, end});
+        expected.push_back(plain.empty() ? -1 : pathLength(plain));
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(3, 0);
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&, t] {
+            ParallelBfs engine(solver.getMoves(), 8);
+            engine.setMinParallelCells(0);
+            for (size_t i = 0; i < queries.size(); ++i) {
+                if (t == 0 && i % 50 == 0) {
+                    engine.setThreadCount(2 + static_cast<unsigned>(i / 50) % 7); // Replaces the pool
+                }
+                if (!isPathOfLength(maze, engine.findPath(queries[i].first, queries[i].second), queries[i].first,
+                                    queries[i].second, expected[i])) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        CHECK(count == 0);
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(16);
+    for (int trial = 0; trial < 40; ++trial) {
+        // 300x300 is above the default threshold of 65536 cells
+        Grid<char> maze = trial % 8 == 7 ? randomMaze(300, 300, 25, rng) : testMaze(trial, rng);
+        dekstra solver(maze);
+        ParallelBfs engine(solver.getMoves(), 1 + trial % 4);
+        engine.setMinParallelCells(0);
+        for (int query = 0; query < 20; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = query == 0 ? start : randomOpenCell(maze, rng);
+            MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end, SearchMode::Bidirectional);
+            int expected = plain.empty() ? -1 : pathLength(plain);
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::LevelSynchronous), start, end,
+                                 expected));
+            CHECK(isPathOfLength(maze, engine.findPath(start, end), start, end, expected));
+            if (expected > 0) {
+                CHECK(engine.getLastLevels() >= expected);
+            }
+        }
+    }
+    checkContention(rng);
+    return finishTests("level_bfs");
+}
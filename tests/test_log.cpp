@@ -0,0 +1,94 @@
+// test_log.cpp
+// Runtime log-level filtering: a message is written only when its level
+// is compiled in and at or below logging::level(), and a filtered
+// message's arguments are never evaluated.
+#include "test_util.h"
+#include <sstream>
+#include <string>
+
+static int evaluated = 0;
+
+static int countEvaluation() {
+    return ++evaluated;
+}
+
+// Redirects std::cout and std::cerr into strings for one scope.
+class Capture {
+public:
+    Capture() : oldOut(std::cout.rdbuf(out.rdbuf())), oldErr(std::cerr.rdbuf(err.rdbuf())) {}
+    ~Capture() {
+        std::cout.rdbuf(oldOut);
+        std::cerr.rdbuf(oldErr);
+    }
+    std::string outText() const { return out.str(); }
+    std::string errText() const { return err.str(); }
+
+private:
+    std::ostringstream out;
+    std::ostringstream err;
+    std::streambuf* oldOut;
+    std::streambuf* oldErr;
+};
+
+static void checkLevel(int level) {
+    logging::setLevel(level);
+    CHECK(logging::level() == level);
+    evaluated = 0;
+    Capture capture;
+    LOG_ERROR("error " << countEvaluation());
+    LOG_INFO("info " << countEvaluation());
+    LOG_DEBUG("debug " << countEvaluation());
+    LOG_TRACE("trace " << countEvaluation());
+
+    bool error = level >= LOG_LEVEL_ERROR && LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR;
+    bool info = level >= LOG_LEVEL_INFO && LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO;
+    bool debug = level >= LOG_LEVEL_DEBUG && LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG;
+    bool trace = level >= LOG_LEVEL_TRACE && LOG_COMPILE_LEVEL >= LOG_LEVEL_TRACE;
+    std::string out = capture.outText();
+    std::string err = capture.errText();
+    CHECK((err.find("error") != std::string::npos) == error);
+    CHECK((out.find("info") != std::string::npos) == info);
+    CHECK((out.find("debug") != std::string::npos) == debug);
+    CHECK((out.find("trace") != std::string::npos) == trace);
+    CHECK(out.find("error") == std::string::npos && err.find("info") == std::string::npos);
+    CHECK(evaluated == error + info + debug + trace);
+    // One line per message, ended by '\n'
+    size_t lines = 0;
+    for (char c : out + err) {
+        lines += c == '\n';
+    }
+    CHECK(lines == static_cast<size_t>(evaluated));
+}
+
+// At LOG_LEVEL_ERROR a query does no I/O unless it fails.
+static void checkSolverOutput() {
+    std::mt19937 rng(4);
+    Grid<char> maze = generatedMaze(31, 31, 10, rng);
+    std::pair<int, int> start = randomOpenCell(maze, rng);
+    std::pair<int, int> end = randomOpenCell(maze, rng);
+    logging::setLevel(LOG_LEVEL_ERROR);
+    {
+        Capture capture;
+        dekstra solver(maze);
+        CHECK(!solver.findShortestPath(start, end).empty());
+        CHECK(capture.outText().empty() && capture.errText().empty());
+        CHECK(solver.findShortestPath(start, {-1, 0}).empty());
+        CHECK(capture.outText().empty() && !capture.errText().empty());
+    }
+    logging::setLevel(LOG_LEVEL_NONE);
+    {
+        Capture capture;
+        dekstra solver(maze);
+        CHECK(solver.findShortestPath(start, {-1, 0}).empty());
+        CHECK(capture.outText().empty() && capture.errText().empty());
+    }
+}
+
+int main() {
+    beginTests();
+    for (int level = LOG_LEVEL_NONE; level <= LOG_LEVEL_TRACE; ++level) {
+        checkLevel(level);
+    }
+    checkSolverOutput();
+    return finishTests("log");
+}
@@ -0,0 +1,63 @@
+// test_memory.cpp
+// Per-cell memory: search labels pick narrow distances when they fit, and
+// a freshly built solver stays within a few bytes per cell because engine
+// workspaces are only allocated by their first query.
+#include "search_labels.h"
+#include "test_util.h"
+#include <fstream>
+#include <unistd.h>
+
+// Resident set size in bytes, or 0 where /proc is not available.
+static size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total = 0;
+    size_t resident = 0;
+    if (!(statm >> total >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+int main() {
+    beginTests();
+    const int offset[4] = {-256, 1, 256, -1};
+    SearchLabels narrow(256, 255, offset);
+    SearchLabels wide(256, 257, offset);
+    CHECK(narrow.isNarrow());
+    CHECK(!wide.isNarrow());
+    // Flags byte plus a 2- or 4-byte distance, and a little for block stamps
+    CHECK(narrow.memoryUsage() <= 256 * 255 * 3 + 256 * 255 / 8);
+    CHECK(wide.memoryUsage() <= 256 * 257 * 5 + 256 * 257 / 8);
+
+    // Labels still work past 65535 in the wide form
+    const int longOffset[4] = {-70000, 1, 70000, -1};
+    SearchLabels line(70000, 1, longOffset);
+    line.begin();
+    line.setRoot(0);
+    for (int cell = 1; cell < 70000; ++cell) {
+        line.label(cell, cell, 3);
+    }
+    CHECK(line.distance(69999) == 69999);
+    CHECK(line.parent(69999) == 69998);
+    CHECK(line.parent(0) == -1);
+
+    const int size = 2000;
+    Grid<char> maze(size, size, '-');
+    size_t before = residentBytes();
+    if (before == 0) {
+        std::printf("memory: no /proc, resident size not checked\n");
+        return finishTests("memory");
+    }
+    {
+        dekstra solver(maze);
+        double perCell = static_cast<double>(residentBytes() - before) / maze.size();
+        std::printf("memory: fresh solver holds %.1f resident bytes per cell\n", perCell);
+        // Masks, component labels and the two packed label sets. Eagerly
+        // allocated engine workspaces would add well over 16 more.
+        CHECK(perCell < 16.0);
+
+        std::pair<int, int> corner = {size - 1, size - 1};
+        CHECK(isPathOfLength(maze, solver.findShortestPath({0, 0}, corner), {0, 0}, corner, 2 * (size - 1)));
+    }
+    return finishTests("memory");
+}
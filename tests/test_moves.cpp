@@ -0,0 +1,57 @@
+// test_moves.cpp
+// Routes follow the precomputed direction masks: four-way steps between
+// open cells, with 'I' and 'O' never connected to each other.
+#include "test_util.h"
+
+// A shortest route, or none when the reference search finds none.
+static bool isRoute(const Grid<char>& maze, const MyVector<std::pair<int, int>>& path,
+                    const std::pair<int, int>& start, const std::pair<int, int>& end) {
+    return isPathOfLength(maze, path, start, end, referenceDistance(maze, start, end));
+}
+
+static void checkTerminals() {
+    const char* adjacent[] = {"+++++", "+IO-+", "+++++"};
+    Grid<char> blocked = fromRows(adjacent, 3);
+    dekstra blockedSolver(blocked);
+    CHECK(blockedSolver.findShortestPath({1, 1}, {2, 1}).empty());
+    CHECK(blockedSolver.findShortestPath({1, 1}, {3, 1}).empty());
+
+    const char* apart[] = {"+++++", "+I-O+", "+++++"};
+    Grid<char> open = fromRows(apart, 3);
+    dekstra openSolver(open);
+    CHECK(isRoute(open, openSolver.findShortestPath({1, 1}, {3, 1}), {1, 1}, {3, 1}));
+
+    // A terminal in a corridor is walkable from plain cells on both sides
+    const char* through[] = {"+++++", "+-I-+", "+++++"};
+    Grid<char> corridor = fromRows(through, 3);
+    dekstra corridorSolver(corridor);
+    CHECK(isRoute(corridor, corridorSolver.findShortestPath({1, 1}, {3, 1}), {1, 1}, {3, 1}));
+
+    // ...but two touching terminals cut it
+    const char* cut[] = {"++++++", "+-IO-+", "++++++"};
+    Grid<char> split = fromRows(cut, 3);
+    dekstra splitSolver(split);
+    CHECK(splitSolver.findShortestPath({1, 1}, {4, 1}).empty());
+
+    const char* walls[] = {"+++", "+-+", "+++"};
+    Grid<char> closed = fromRows(walls, 3);
+    dekstra closedSolver(closed);
+    CHECK(closedSolver.findShortestPath({1, 1}, {0, 0}).empty());
+    CHECK(closedSolver.findShortestPath({0, 1}, {1, 1}).empty());
+}
+
+int main() {
+    beginTests();
+    checkTerminals();
+    std::mt19937 rng(3);
+    for (int trial = 0; trial < 30; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        for (int query = 0; query < 10; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            CHECK(isRoute(maze, solver.findShortestPath(start, end), start, end));
+        }
+    }
+    return finishTests("moves");
+}
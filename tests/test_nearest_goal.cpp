@@ -0,0 +1,83 @@
+// test_nearest_goal.cpp
+// Nearest-goal searches reach the closest goal in every mode, skip goals
+// that are invalid or cut off, and findNearestExit finds the closest exit.
+#include "test_util.h"
+
+static const SearchMode modes[4] = {SearchMode::Bidirectional, SearchMode::AStar, SearchMode::BidirectionalAStar,
+                                    SearchMode::ParallelBidirectional};
+
+static int nearestDistance(const Grid<char>& maze, const std::pair<int, int>& start,
+                           const MyVector<std::pair<int, int>>& goals) {
+    int best = -1;
+    for (size_t i = 0; i < goals.size(); ++i) {
+        if (!maze.inBounds(goals[i].first, goals[i].second) || !isOpenCell(maze(goals[i].first, goals[i].second))) {
+            continue;
+        }
+        int distance = referenceDistance(maze, start, goals[i]);
+        if (distance >= 0 && (best < 0 || distance < best)) {
+            best = distance;
+        }
+    }
+    return best;
+}
+
+static void checkNearest(const Grid<char>& maze, const MyVector<std::pair<int, int>>& path,
+                         const std::pair<int, int>& start, const MyVector<std::pair<int, int>>& goals) {
+    int expected = nearestDistance(maze, start, goals);
+    if (expected < 0) {
+        CHECK(path.empty());
+        return;
+    }
+    CHECK(!path.empty());
+    if (path.empty()) {
+        return;
+    }
+    const std::pair<int, int>& reached = path[path.size() - 1];
+    bool listed = false;
+    for (size_t i = 0; i < goals.size(); ++i) {
+        listed = listed || goals[i] == reached;
+    }
+    CHECK(listed);
+    CHECK(isPathOfLength(maze, path, start, reached, expected));
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(13);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        for (int query = 0; query < 10; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            MyVector<std::pair<int, int>> goals;
+            int count = 1 + static_cast<int>(rng() % 6);
+            for (int i = 0; i < count; ++i) {
+                goals.push_back(randomOpenCell(maze, rng));
+            }
+            goals.push_back(goals[0]);        // duplicates are fine
+            goals.push_back({-1, maze.height()}); // and so are invalid goals
+            if (query == 0) {
+                goals.push_back(start);
+            }
+            for (SearchMode mode : modes) {
+                checkNearest(maze, solver.findNearestGoal(start, goals, mode), start, goals);
+            }
+        }
+    }
+
+    for (int trial = 0; trial < 10; ++trial) {
+        MazeGenerator generator(21 + 2 * static_cast<int>(rng() % 20), 21 + 2 * static_cast<int>(rng() % 20));
+        std::srand(static_cast<unsigned>(rng()));
+        generator.generate();
+        generator.addExits(1 + static_cast<int>(rng() % 5));
+        const Grid<char>& maze = generator.getMaze();
+        dekstra solver(maze);
+        MyVector<std::pair<int, int>> exits = generator.getExitPoints();
+        CHECK(solver.getExits().size() == exits.size());
+        for (int query = 0; query < 10; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            checkNearest(maze, solver.findNearestExit(start), start, exits);
+        }
+    }
+    return finishTests("nearest_goal");
+}
@@ -0,0 +1,77 @@
+// test_parallel_bidirectional.cpp
+// The two-thread bidirectional mode against plain bidirectional search.
+// Many short queries on one solver give the two threads plenty of chances
+// to race at the meeting point, and several solvers queried at once from
+// their own threads oversubscribe the cores so the sides get preempted
+// mid-expansion.
+#include "test_util.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const QueueKind kinds[4] = {QueueKind::BinaryHeap, QueueKind::Bucket, QueueKind::Fifo, QueueKind::Radix};
+
+static void checkContention(std::mt19937& rng) {
+    // Every worker of a pool runs each job exactly once
+    ThreadPool pool(2);
+    std::atomic<int> calls[2];
+    calls[0] = 0;
+    calls[1] = 0;
+    for (int round = 0; round < 2000; ++round) {
+        pool.run([&calls](unsigned id) { ++calls[id]; });
+    }
+    CHECK(pool.size() == 2 && calls[0] == 2000 && calls[1] == 2000);
+
+    Grid<char> maze = randomMaze(14, 10, 25, rng);
+    MyVector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+    for (int i = 0; i < 1500; ++i) {
+        queries.push_back({randomOpenCell(maze, rng), randomOpenCell(maze, rng)});
+    }
+    dekstra reference(maze);
+    MyVector<int> expected(queries.size(), -1);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        MyVector<std::pair<int, int>> path = reference.findShortestPath(queries[i].first, queries[i].second);
+        expected[i] = path.empty() ? -1 : pathLength(path);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            dekstra solver(maze);
+            solver.setQueueKind(kinds[t]);
+            for (size_t i = 0; i < queries.size(); ++i) {
+                MyVector<std::pair<int, int>> path =
+                    solver.findShortestPath(queries[i].first, queries[i].second, SearchMode::ParallelBidirectional);
+                if (!isPathOfLength(maze, path, queries[i].first, queries[i].second, expected[i])) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        CHECK(count == 0);
+    }
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(15);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = trial % 4 == 3 ? randomMaze(150, 150, 25, rng) : testMaze(trial, rng);
+        dekstra solver(maze);
+        for (int query = 0; query < 40; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = query == 0 ? start : randomOpenCell(maze, rng);
+            MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end, SearchMode::Bidirectional);
+            int expected = plain.empty() ? -1 : pathLength(plain);
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::ParallelBidirectional), start,
+                                 end, expected));
+        }
+    }
+    checkContention(rng);
+    return finishTests("parallel_bidirectional");
+}
@@ -0,0 +1,81 @@
+// test_path_cache.cpp
+// Cached paths equal fresh ones, repeats hit, the least recently used entry
+// is evicted, and edits, a mode change or a hierarchy rebuild never return
+// a stale path.
+#include "path_cache.h"
+#include "test_util.h"
+
+int main() {
+    beginTests();
+    std::mt19937 rng(12);
+    for (int trial = 0; trial < 20; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        PathCache cache(solver, 4);
+        MyVector<std::pair<int, int>> starts;
+        MyVector<std::pair<int, int>> ends;
+        for (int i = 0; i < 4; ++i) {
+            starts.push_back(randomOpenCell(maze, rng));
+            ends.push_back(randomOpenCell(maze, rng));
+        }
+        for (int round = 0; round < 2; ++round) {
+            for (size_t i = 0; i < starts.size(); ++i) {
+                int expected = referenceDistance(maze, starts[i], ends[i]);
+                CHECK(isPathOfLength(maze, cache.findShortestPath(starts[i], ends[i]), starts[i], ends[i], expected));
+            }
+        }
+        CHECK(cache.getMisses() == 4);
+        CHECK(cache.getHits() == 4);
+        CHECK(cache.size() == 4);
+
+        // A fifth query evicts the oldest, starts[0]
+        cache.resetStats();
+        std::pair<int, int> extra = randomOpenCell(maze, rng);
+        cache.findShortestPath(extra, extra);
+        cache.findShortestPath(starts[1], ends[1]);
+        cache.findShortestPath(starts[0], ends[0]);
+        CHECK(cache.getHits() == 1);
+        CHECK(cache.getMisses() == 2);
+        CHECK(cache.size() == 4);
+
+        // Another mode is another key
+        cache.resetStats();
+        solver.setSearchMode(SearchMode::AStar);
+        cache.findShortestPath(starts[0], ends[0]);
+        CHECK(cache.getMisses() == 1);
+        solver.setSearchMode(SearchMode::Bidirectional);
+
+        // Rebuilding the hierarchy with other clusters changes hierarchical
+        // routes, and clearing it makes that mode refuse queries
+        solver.setSearchMode(SearchMode::Hierarchical);
+        solver.buildHierarchy(4);
+        cache.findShortestPath(starts[0], ends[0]);
+        solver.buildHierarchy(8);
+        cache.resetStats();
+        dekstra rebuilt(maze);
+        rebuilt.buildHierarchy(8);
+        CHECK(cache.findShortestPath(starts[0], ends[0]).size() ==
+              rebuilt.findShortestPath(starts[0], ends[0], SearchMode::Hierarchical).size());
+        CHECK(cache.getMisses() == 1 && cache.getHits() == 0);
+        solver.clearHierarchy();
+        CHECK(cache.findShortestPath(starts[0], ends[0]).empty());
+        CHECK(cache.getMisses() == 2);
+        solver.setSearchMode(SearchMode::Bidirectional);
+
+        // An edit makes every entry stale
+        for (int edit = 0; edit < 10; ++edit) {
+            std::pair<int, int> cell = randomOpenCell(maze, rng);
+            maze(cell.first, cell.second) = '+';
+        }
+        solver.onMazeChanged();
+        cache.resetStats();
+        for (size_t i = 0; i < starts.size(); ++i) {
+            int expected = maze(starts[i].first, starts[i].second) == '-' && maze(ends[i].first, ends[i].second) == '-'
+                               ? referenceDistance(maze, starts[i], ends[i])
+                               : -1;
+            CHECK(isPathOfLength(maze, cache.findShortestPath(starts[i], ends[i]), starts[i], ends[i], expected));
+        }
+        CHECK(cache.getHits() == 0);
+    }
+    return finishTests("path_cache");
+}
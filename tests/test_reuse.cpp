@@ -0,0 +1,63 @@
+// test_reuse.cpp
+// One solver answering many queries gives exactly what a fresh solver
+// gives, and reset() forgets the previous query's labels.
+#include "test_util.h"
+
+static bool samePath(const MyVector<std::pair<int, int>>& a, const MyVector<std::pair<int, int>>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool anyVisited(const dekstra& solver, const Grid<char>& maze) {
+    for (int y = 0; y < maze.height(); ++y) {
+        for (int x = 0; x < maze.width(); ++x) {
+            if (solver.isVisited(x, y)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool onlyOpenVisited(const dekstra& solver, const Grid<char>& maze) {
+    for (int y = 0; y < maze.height(); ++y) {
+        for (int x = 0; x < maze.width(); ++x) {
+            if (solver.isVisited(x, y) && !isOpenCell(maze(x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(2);
+    for (int trial = 0; trial < 30; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra reused(maze);
+        CHECK(!anyVisited(reused, maze));
+        for (int query = 0; query < 15; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            dekstra fresh(maze);
+            MyVector<std::pair<int, int>> expected = fresh.findShortestPath(start, end);
+            CHECK(samePath(reused.findShortestPath(start, end), expected));
+            CHECK(onlyOpenVisited(reused, maze));
+            // Labels from a failed query must not leak into the next one
+            CHECK(reused.findShortestPath(start, {-1, -1}).empty());
+            CHECK(samePath(reused.findShortestPath(start, end), expected));
+        }
+        reused.reset();
+        CHECK(!anyVisited(reused, maze));
+        CHECK(!reused.isVisited(-1, 0) && !reused.isVisited(maze.width(), 0));
+    }
+    return finishTests("reuse");
+}
@@ -0,0 +1,145 @@
+// test_search_core.cpp
+// Queries built on SearchCore: breadth-first paths match plain
+// bidirectional search, as do SearchCore runs over each FrontierPolicy, and
+// weighted and diagonal paths cost the same as a reference Dijkstra over the
+// same moves.
+#include "test_util.h"
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
+
+static const double diagonal = 1.4142135623730951;
+
+// Diagonal step between `from` and the cell `delta` away, open only when
+// both L-shaped routes are.
+static bool diagonalOpen(const Grid<unsigned char>& moves, int from, int a, int b) {
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    return (moves[from] & (1 << a)) && (moves[from] & (1 << b)) && (moves[from + offset[a]] & (1 << b)) &&
+           (moves[from + offset[b]] & (1 << a));
+}
+
+// Dijkstra over the masks; stepCost(next, isDiagonal) gives each step.
+static double referenceCost(const Grid<unsigned char>& moves, int source, int target, bool diagonals,
+                            const std::function<double(int, bool)>& stepCost) {
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    std::vector<double> dist(moves.size(), -1.0);
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    dist[source] = 0.0;
+    open.push({0.0, source});
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        if (top.first > dist[top.second]) {
+            continue;
+        }
+        if (top.second == target) {
+            return top.first;
+        }
+        auto relax = [&](int next, bool isDiagonal) {
+            double cost = top.first + stepCost(next, isDiagonal);
+            if (dist[next] < 0 || cost < dist[next] - 1e-9) {
+                dist[next] = cost;
+                open.push({cost, next});
+            }
+        };
+        for (int dir = 0; dir < 4; ++dir) {
+            if (moves[top.second] & (1 << dir)) {
+                relax(top.second + offset[dir], false);
+            }
+            int b = (dir + 1) & 3;
+            if (diagonals && diagonalOpen(moves, top.second, dir, b)) {
+                relax(top.second + offset[dir] + offset[b], true);
+            }
+        }
+    }
+    return -1.0;
+}
+
+// Cost of a returned path, or -1 when a step is not allowed.
+static double pathCost(const Grid<unsigned char>& moves, const MyVector<std::pair<int, int>>& path,
+                       const std::function<double(int, bool)>& stepCost) {
+    const int offset[4] = {-moves.width(), 1, moves.width(), -1};
+    double cost = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        int from = static_cast<int>(moves.index(path[i - 1].first, path[i - 1].second));
+        int to = static_cast<int>(moves.index(path[i].first, path[i].second));
+        bool allowed = false;
+        bool isDiagonal = false;
+        for (int dir = 0; dir < 4; ++dir) {
+            int b = (dir + 1) & 3;
+            if ((moves[from] & (1 << dir)) && from + offset[dir] == to) {
+                allowed = true;
+            } else if (diagonalOpen(moves, from, dir, b) && from + offset[dir] + offset[b] == to) {
+                allowed = true;
+                isDiagonal = true;
+            }
+        }
+        if (!allowed) {
+            return -1.0;
+        }
+        cost += stepCost(to, isDiagonal);
+    }
+    return cost;
+}
+
+// Unit-cost distance from source to target through a SearchCore on the
+// FrontierQueue backend `Kind`, or -1 when there is none.
+template <QueueKind Kind>
+static int frontierDistance(const Grid<unsigned char>& moves, int source, int target) {
+    SearchCore<int, FourNeighbors, UnitCells<int>, FrontierPolicy<Kind>> core(FourNeighbors(moves), UnitCells<int>(),
+                                                                              moves.size());
+    return core.run(source, target) ? core.distance(target) : -1;
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(20);
+    for (int trial = 0; trial < 40; ++trial) {
+        Grid<char> maze = testMaze(trial, rng);
+        dekstra solver(maze);
+        const Grid<unsigned char>& moves = solver.getMoves();
+        Grid<int> weights(maze.width(), maze.height(), 1);
+        for (size_t cell = 0; cell < weights.size(); ++cell) {
+            weights[cell] = static_cast<int>(rng() % 10);
+        }
+        auto weighted = [&](int next, bool) { return static_cast<double>(weights[next]); };
+        auto octile = [&](int, bool isDiagonal) { return isDiagonal ? diagonal : 1.0; };
+
+        for (int query = 0; query < 15; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            int source = static_cast<int>(maze.index(start.first, start.second));
+            int target = static_cast<int>(maze.index(end.first, end.second));
+            MyVector<std::pair<int, int>> plain = solver.findShortestPath(start, end, SearchMode::Bidirectional);
+            int expected = plain.empty() ? -1 : pathLength(plain);
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end, SearchMode::BreadthFirst), start, end,
+                                 expected));
+            CHECK(frontierDistance<QueueKind::BinaryHeap>(moves, source, target) == expected);
+            CHECK(frontierDistance<QueueKind::Bucket>(moves, source, target) == expected);
+            CHECK(frontierDistance<QueueKind::Fifo>(moves, source, target) == expected);
+            CHECK(frontierDistance<QueueKind::Radix>(moves, source, target) == expected);
+
+            MyVector<std::pair<int, int>> path = solver.findWeightedPath(start, end, weights);
+            double cost = referenceCost(moves, source, target, false, weighted);
+            CHECK(path.empty() == (cost < 0));
+            if (!path.empty()) {
+                CHECK(path[0] == start && path[path.size() - 1] == end);
+                CHECK(std::fabs(pathCost(moves, path, weighted) - cost) < 1e-6);
+            }
+
+            path = solver.findDiagonalPath(start, end);
+            cost = referenceCost(moves, source, target, true, octile);
+            CHECK(path.empty() == (cost < 0));
+            if (!path.empty()) {
+                CHECK(path[0] == start && path[path.size() - 1] == end);
+                CHECK(std::fabs(pathCost(moves, path, octile) - cost) < 1e-6);
+            }
+        }
+        // Step costs must cover the whole maze
+        std::pair<int, int> open = randomOpenCell(maze, rng);
+        CHECK(solver.findWeightedPath(open, open, Grid<int>(1, 1, 1)).empty());
+    }
+    return finishTests("search_core");
+}
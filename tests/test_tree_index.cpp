@@ -0,0 +1,34 @@
+// test_tree_index.cpp
+// The LCA index on cycle-free mazes: distances and paths match plain
+// bidirectional search, and mazes with cycles are refused.
+#include "test_util.h"
+
+int main() {
+    beginTests();
+    std::mt19937 rng(10);
+    for (int trial = 0; trial < 30; ++trial) {
+        Grid<char> maze = generatedMaze(9 + static_cast<int>(rng() % 60), 9 + static_cast<int>(rng() % 60), 0, rng);
+        dekstra reference(maze);
+        dekstra solver(maze);
+        CHECK(solver.buildTreeIndex());
+        CHECK(solver.hasTreeIndex());
+        for (int query = 0; query < 30; ++query) {
+            std::pair<int, int> start = randomOpenCell(maze, rng);
+            std::pair<int, int> end = randomOpenCell(maze, rng);
+            MyVector<std::pair<int, int>> plain = reference.findShortestPath(start, end);
+            int expected = plain.empty() ? -1 : pathLength(plain);
+            CHECK(solver.distance(start, end) == expected);
+            CHECK(isPathOfLength(maze, solver.findShortestPath(start, end), start, end, expected));
+        }
+
+        Grid<char> braided = generatedMaze(15 + static_cast<int>(rng() % 40), 15 + static_cast<int>(rng() % 40), 20,
+                                           rng);
+        dekstra cyclic(braided);
+        CHECK(!cyclic.buildTreeIndex());
+        CHECK(!cyclic.hasTreeIndex());
+        std::pair<int, int> start = randomOpenCell(braided, rng);
+        std::pair<int, int> end = randomOpenCell(braided, rng);
+        CHECK(cyclic.distance(start, end) == referenceDistance(braided, start, end));
+    }
+    return finishTests("tree_index");
+}
@@ -0,0 +1,176 @@
+// test_util.h
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include "dekstra.h"
+#include "log.h"
+#include "maze.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <utility>
+
+// Shared helpers for the behaviour tests. Every test is a plain executable
+// that exits non-zero when a CHECK failed, so ctest needs no framework.
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+inline void reportFailure(const char* file, int line, const char* what) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+    ++failureCount();
+}
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            reportFailure(__FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+// Silences the solvers; several checks log expected errors on purpose.
+inline void beginTests() {
+    logging::setLevel(LOG_LEVEL_NONE);
+}
+
+inline int finishTests(const char* name) {
+    std::printf("%s: %d failure(s)\n", name, failureCount());
+    return failureCount() == 0 ? 0 : 1;
+}
+
+inline bool isOpenCell(char cell) {
+    return cell == '-' || cell == 'I' || cell == 'O';
+}
+
+// The step rule dekstra builds its masks from: both cells open, and not
+// both of them terminals.
+inline bool canStep(const Grid<char>& maze, const std::pair<int, int>& from, const std::pair<int, int>& to) {
+    if (!maze.inBounds(from.first, from.second) || !maze.inBounds(to.first, to.second)) {
+        return false;
+    }
+    if (std::abs(from.first - to.first) + std::abs(from.second - to.second) != 1) {
+        return false;
+    }
+    char a = maze(from.first, from.second);
+    char b = maze(to.first, to.second);
+    bool terminalA = (a == 'I' || a == 'O');
+    bool terminalB = (b == 'I' || b == 'O');
+    return isOpenCell(a) && isOpenCell(b) && !(terminalA && terminalB);
+}
+
+// Plain breadth-first distance with the rule above; -1 when unreachable.
+inline int referenceDistance(const Grid<char>& maze, const std::pair<int, int>& start,
+                             const std::pair<int, int>& end) {
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {-1, 0, 1, 0};
+    Grid<int> dist(maze.width(), maze.height(), -1);
+    std::queue<std::pair<int, int>> queue;
+    dist(start.first, start.second) = 0;
+    queue.push(start);
+    while (!queue.empty()) {
+        std::pair<int, int> at = queue.front();
+        queue.pop();
+        if (at == end) {
+            return dist(at.first, at.second);
+        }
+        for (int dir = 0; dir < 4; ++dir) {
+            std::pair<int, int> next = {at.first + dx[dir], at.second + dy[dir]};
+            if (canStep(maze, at, next) && dist(next.first, next.second) < 0) {
+                dist(next.first, next.second) = dist(at.first, at.second) + 1;
+                queue.push(next);
+            }
+        }
+    }
+    return -1;
+}
+
+// A valid route from start to end in exactly `length` steps, or no route
+// when length is -1.
+inline bool isPathOfLength(const Grid<char>& maze, const MyVector<std::pair<int, int>>& path,
+                           const std::pair<int, int>& start, const std::pair<int, int>& end, int length) {
+    if (length < 0) {
+        return path.empty();
+    }
+    if (path.size() != static_cast<size_t>(length) + 1 || path[0] != start || path[path.size() - 1] != end) {
+        return false;
+    }
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!canStep(maze, path[i - 1], path[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline int pathLength(const MyVector<std::pair<int, int>>& path) {
+    return static_cast<int>(path.size()) - 1;
+}
+
+// Open grid with roughly wallPercent walls placed at random.
+inline Grid<char> randomMaze(int width, int height, int wallPercent, std::mt19937& rng) {
+    Grid<char> maze(width, height, '-');
+    for (size_t cell = 0; cell < maze.size(); ++cell) {
+        if (static_cast<int>(rng() % 100) < wallPercent) {
+            maze[cell] = '+';
+        }
+    }
+    return maze;
+}
+
+// Generated perfect maze with odd dimensions; `braidPercent` of the
+// interior walls are then knocked out to add cycles.
+inline Grid<char> generatedMaze(int width, int height, int braidPercent, std::mt19937& rng) {
+    MazeGenerator generator(width | 1, height | 1);
+    std::srand(static_cast<unsigned>(rng())); // the generator seeds itself from the clock
+    generator.generate();
+    Grid<char> maze = generator.getMaze();
+    for (int y = 1; y + 1 < maze.height(); ++y) {
+        for (int x = 1; x + 1 < maze.width(); ++x) {
+            if (maze(x, y) == '+' && static_cast<int>(rng() % 100) < braidPercent) {
+                maze(x, y) = '-';
+            }
+        }
+    }
+    return maze;
+}
+
+// Hand-drawn maze, one string per row.
+inline Grid<char> fromRows(const char* const* rows, int height) {
+    int width = static_cast<int>(std::strlen(rows[0]));
+    Grid<char> maze(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            maze(x, y) = rows[y][x];
+        }
+    }
+    return maze;
+}
+
+inline std::pair<int, int> randomOpenCell(const Grid<char>& maze, std::mt19937& rng) {
+    while (true) {
+        std::pair<int, int> cell = {static_cast<int>(rng() % maze.width()), static_cast<int>(rng() % maze.height())};
+        if (maze(cell.first, cell.second) == '-') {
+            return cell;
+        }
+    }
+}
+
+// A mix of generated and random mazes of modest size for cross-checks.
+inline Grid<char> testMaze(int trial, std::mt19937& rng) {
+    int width = 9 + static_cast<int>(rng() % 50);
+    int height = 9 + static_cast<int>(rng() % 50);
+    switch (trial % 3) {
+    case 0:
+        return generatedMaze(width, height, 0, rng);
+    case 1:
+        return generatedMaze(width, height, 10, rng);
+    default:
+        return randomMaze(width, height, 20 + static_cast<int>(rng() % 25), rng);
+    }
+}
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,65 @@
+// test_wavefront.cpp
+// The bitmap wavefront gives the same distance field as the plain
+// breadth-first one, on sizes that are not multiples of the 8x8 tiles, on
+// open grids where it sweeps whole bands and on corridor mazes where it
+// follows a sparse frontier.
+#include "distance_field.h"
+#include "test_util.h"
+#include "wavefront.h"
+
+// A DEKSTRA_AVX2 build must really compile the vector path it is testing
+#if defined(DEKSTRA_AVX2) && !defined(__AVX2__)
+#error "DEKSTRA_AVX2 is set but the compiler is not targeting AVX2"
+#endif
+
+// Terminals are plain cells here: the bitmap needs every pair of adjacent
+// open cells to be connected.
+static Grid<char> withoutTerminals(Grid<char> maze) {
+    for (size_t cell = 0; cell < maze.size(); ++cell) {
+        if (maze[cell] == 'I' || maze[cell] == 'O') {
+            maze[cell] = '-';
+        }
+    }
+    return maze;
+}
+
+int main() {
+    beginTests();
+    std::mt19937 rng(17);
+    BitWavefront wavefront; // reused across sizes on purpose
+    for (int trial = 0; trial < 60; ++trial) {
+        Grid<char> maze;
+        if (trial % 3 == 0) {
+            maze = randomMaze(1 + static_cast<int>(rng() % 90), 1 + static_cast<int>(rng() % 90),
+                              static_cast<int>(rng() % 45), rng);
+        } else {
+            maze = withoutTerminals(testMaze(trial, rng));
+        }
+        if (trial == 59) {
+            maze = randomMaze(400, 257, 10, rng);
+        }
+        bool anyOpen = false;
+        for (size_t cell = 0; cell < maze.size(); ++cell) {
+            anyOpen = anyOpen || maze[cell] == '-';
+        }
+        if (!anyOpen) {
+            continue;
+        }
+        dekstra solver(maze);
+        for (int source = 0; source < 3; ++source) {
+            std::pair<int, int> from = randomOpenCell(maze, rng);
+            int cell = static_cast<int>(maze.index(from.first, from.second));
+            Grid<int> expected;
+            Grid<int> actual;
+            computeDistanceField(solver.getMoves(), cell, expected);
+            wavefront.compute(solver.getMoves(), cell, actual);
+            CHECK(actual.width() == expected.width() && actual.height() == expected.height());
+            bool same = actual.size() == expected.size();
+            for (size_t i = 0; same && i < expected.size(); ++i) {
+                same = actual[i] == expected[i];
+            }
+            CHECK(same);
+        }
+    }
+    return finishTests("wavefront");
+}
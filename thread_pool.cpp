@@ -0,0 +1,54 @@
+// thread_pool.cpp
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(unsigned threadCount) : job(nullptr), generation(0), running(0), stopping(false) {
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::run(const std::function<void(unsigned)>& job) {
+    std::unique_lock<std::mutex> guard(lock);
+    this->job = &job;
+    running = static_cast<unsigned>(threads.size());
+    ++generation;
+    wake.notify_all();
+    done.wait(guard, [this] { return running == 0; });
+    this->job = nullptr;
+}
+
+unsigned ThreadPool::size() const {
+    return static_cast<unsigned>(threads.size());
+}
+
+void ThreadPool::workerLoop(unsigned id) {
+    unsigned seen = 0;
+    while (true) {
+        const std::function<void(unsigned)>* current;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            current = job;
+        }
+        (*current)(id);
+        std::lock_guard<std::mutex> guard(lock);
+        if (--running == 0) {
+            done.notify_one();
+        }
+    }
+}
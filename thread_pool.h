@@ -0,0 +1,40 @@
+// thread_pool.h
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that sleep between jobs. run() hands one job
+// to every worker at once, so callers that split work the same way for
+// each query pay for a wake-up rather than a thread start.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Calls job(id) on every worker, id in [0, size()), and returns once all
+    // calls have. Only one run() at a time.
+    void run(const std::function<void(unsigned)>& job);
+    unsigned size() const;
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(unsigned)>* job;
+    unsigned generation; // bumped for every job the workers should pick up
+    unsigned running;    // workers still busy with the current job
+    bool stopping;
+
+    void workerLoop(unsigned id);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,136 @@
+// tree_index.cpp
+#include "tree_index.h"
+#include "log.h"
+
+TreeIndex::TreeIndex() : width(0), built(false) {}
+
+bool TreeIndex::build(const Grid<unsigned char>& moves) {
+    clear();
+    width = moves.width();
+    int height = moves.height();
+    parent = Grid<int>(width, height, -1);
+    jump = Grid<int>(width, height, -1);
+    depth = Grid<int>(width, height, 0);
+    component = Grid<int>(width, height, -1);
+
+    const int offset[4] = {-width, 1, width, -1};
+    MyVector<int> buffer(moves.size());
+    int* queue = buffer.begin();
+    int components = 0;
+
+    for (size_t root = 0; root < moves.size(); ++root) {
+        if (moves[root] == 0 || component[root] >= 0) {
+            continue;
+        }
+        // Breadth-first from the root: parents are always finished before
+        // their children, which the jump pointers rely on.
+        size_t head = 0;
+        size_t tail = 0;
+        size_t degreeSum = 0;
+        component[root] = components;
+        parent[root] = -1;
+        jump[root] = static_cast<int>(root);
+        depth[root] = 0;
+        queue[tail++] = static_cast<int>(root);
+        while (head < tail) {
+            int cell = queue[head++];
+            unsigned char open = moves[cell];
+            for (int dir = 0; dir < 4; ++dir) {
+                if (!(open & (1 << dir))) {
+                    continue;
+                }
+                ++degreeSum;
+                int next = cell + offset[dir];
+                if (component[next] >= 0) {
+                    continue;
+                }
+                component[next] = components;
+                parent[next] = cell;
+                depth[next] = depth[cell] + 1;
+                int up = jump[cell];
+                if (depth[cell] - depth[up] == depth[up] - depth[jump[up]]) {
+                    jump[next] = jump[up];
+                } else {
+                    jump[next] = cell;
+                }
+                queue[tail++] = next;
+            }
+        }
+        // A tree on n cells has exactly n - 1 edges
+        if (degreeSum / 2 != tail - 1) {
+            LOG_DEBUG("Maze has cycles, tree index not built");
+            clear();
+            return false;
+        }
+        ++components;
+    }
+
+    built = true;
+    LOG_DEBUG("Tree index built over " << components << " components");
+    return true;
+}
+
+void TreeIndex::clear() {
+    built = false;
+    parent = Grid<int>();
+    jump = Grid<int>();
+    depth = Grid<int>();
+    component = Grid<int>();
+}
+
+bool TreeIndex::isBuilt() const {
+    return built;
+}
+
+int TreeIndex::lowestCommonAncestor(int a, int b) const {
+    if (depth[a] < depth[b]) {
+        std::swap(a, b);
+    }
+    while (depth[a] > depth[b]) {
+        a = depth[jump[a]] >= depth[b] ? jump[a] : parent[a];
+    }
+    while (a != b) {
+        if (jump[a] != jump[b]) {
+            a = jump[a];
+            b = jump[b];
+        } else {
+            a = parent[a];
+            b = parent[b];
+        }
+    }
+    return a;
+}
+
+int TreeIndex::distance(int from, int to) const {
+    if (from == to) {
+        return 0;
+    }
+    if (component[from] < 0 || component[from] != component[to]) {
+        return -1;
+    }
+    return depth[from] + depth[to] - 2 * depth[lowestCommonAncestor(from, to)];
+}
+
+MyVector<std::pair<int, int>> TreeIndex::path(int from, int to) const {
+    MyVector<std::pair<int, int>> route;
+    if (from == to) {
+        route.push_back({from % width, from / width});
+        return route;
+    }
+    if (component[from] < 0 || component[from] != component[to]) {
+        return route;
+    }
+    int meet = lowestCommonAncestor(from, to);
+    for (int at = from; at != meet; at = parent[at]) {
+        route.push_back({at % width, at / width});
+    }
+    size_t split = route.size();
+    for (int at = to; at != meet; at = parent[at]) {
+        route.push_back({at % width, at / width});
+    }
+    route.push_back({meet % width, meet / width});
+    // The climb from `to` was collected upward; flip it (with the meeting
+    // cell) so the route reads from `from` to `to`.
+    std::reverse(route.begin() + split, route.end());
+    return route;
+}
@@ -0,0 +1,39 @@
+// tree_index.h
+#ifndef TREE_INDEX_H
+#define TREE_INDEX_H
+
+#include "grid.h"
+#include <utility>
+
+// Exact distance oracle for mazes whose open cells form a forest, such as
+// the perfect mazes MazeGenerator carves. Every route is then unique, so a
+// query reduces to finding the lowest common ancestor of its endpoints.
+//
+// Each cell keeps its parent, depth and one skew-binary jump pointer
+// (Myers' scheme): LCA takes O(log n) jumps with three ints per cell,
+// instead of the O(n log n) table of classic binary lifting.
+class TreeIndex {
+public:
+    TreeIndex();
+
+    // Returns false and stays empty if any region of the maze has a cycle.
+    bool build(const Grid<unsigned char>& moves);
+    void clear();
+    bool isBuilt() const;
+
+    // Steps between two cells, or -1 when they are not connected.
+    int distance(int from, int to) const;
+    // Cells from `from` to `to` inclusive; empty when not connected.
+    MyVector<std::pair<int, int>> path(int from, int to) const;
+    int lowestCommonAncestor(int a, int b) const;
+
+private:
+    int width;
+    bool built;
+    Grid<int> parent;
+    Grid<int> jump;
+    Grid<int> depth;
+    Grid<int> component; // -1 for cells no step leads to or from
+};
+
+#endif // TREE_INDEX_H
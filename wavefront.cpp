@@ -0,0 +1,225 @@
+// wavefront.cpp
+#include "wavefront.h"
+#include <cstring>
+#include <utility>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Bit r * 8 + c of a tile is the cell in tile row r, tile column c.
+static const uint64_t column0 = 0x0101010101010101ULL;
+static const uint64_t column7 = 0x8080808080808080ULL;
+static const uint64_t row0 = 0x00000000000000FFULL;
+
+static int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// Bit i set when byte i of the eight at `bytes` is non-zero
+static unsigned nonZeroBytes(const unsigned char* bytes) {
+    uint64_t v;
+    std::memcpy(&v, bytes, sizeof(v));
+    v |= v >> 4;
+    v |= v >> 2;
+    v |= v >> 1;
+    v &= column0;
+    return static_cast<unsigned>((v * 0x0102040810204080ULL) >> 56);
+}
+
+BitWavefront::BitWavefront() : width(0), height(0), stride(0) {}
+
+void BitWavefront::reshape(int width, int height) {
+    if (width == this->width && height == this->height) {
+        return;
+    }
+    this->width = width;
+    this->height = height;
+    // Round up to whole AVX2 vectors, keeping at least one empty guard tile
+    stride = ((static_cast<size_t>(width) + 7) / 8 + 1 + 3) & ~static_cast<size_t>(3);
+    size_t tiles = stride * ((height + 7) / 8 + 2);
+    open = MyVector<uint64_t>(tiles, 0);
+    seen = MyVector<uint64_t>(tiles, 0);
+    frontier = MyVector<uint64_t>(tiles, 0);
+    next = MyVector<uint64_t>(tiles, 0);
+}
+
+// Cells one step from the frontier in or next to `tile`, before masking
+uint64_t BitWavefront::grow(size_t tile) const {
+    const uint64_t* f = frontier.begin() + tile;
+    uint64_t left = f[-1];
+    uint64_t right = f[1];
+    uint64_t up = f[-static_cast<ptrdiff_t>(stride)];
+    uint64_t down = f[stride];
+    return ((f[0] << 1) & ~column0) | ((left >> 7) & column0) | ((f[0] >> 1) & ~column7) |
+           ((right << 7) & column7) | (f[0] << 8) | (up >> 56) | (f[0] >> 8) | (down << 56);
+}
+
+void BitWavefront::sweep(size_t begin, size_t end) {
+    const uint64_t* o = open.begin();
+    const uint64_t* s = seen.begin();
+    uint64_t* n = next.begin();
+    size_t i = begin;
+#ifdef __AVX2__
+    const uint64_t* f = frontier.begin();
+    const __m256i notColumn0 = _mm256_set1_epi64x(static_cast<long long>(~column0));
+    const __m256i notColumn7 = _mm256_set1_epi64x(static_cast<long long>(~column7));
+    const __m256i onlyColumn0 = _mm256_set1_epi64x(static_cast<long long>(column0));
+    const __m256i onlyColumn7 = _mm256_set1_epi64x(static_cast<long long>(column7));
+    for (; i < end; i += 4) {
+        __m256i here = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i));
+        __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i - 1));
+        __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i + 1));
+        __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i - stride));
+        __m256i down = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i + stride));
+        __m256i east = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi64(here, 1), notColumn0),
+                                       _mm256_and_si256(_mm256_srli_epi64(left, 7), onlyColumn0));
+        __m256i west = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi64(here, 1), notColumn7),
+                                       _mm256_and_si256(_mm256_slli_epi64(right, 7), onlyColumn7));
+        __m256i south = _mm256_or_si256(_mm256_slli_epi64(here, 8), _mm256_srli_epi64(up, 56));
+        __m256i north = _mm256_or_si256(_mm256_srli_epi64(here, 8), _mm256_slli_epi64(down, 56));
+        __m256i grown = _mm256_or_si256(_mm256_or_si256(east, west), _mm256_or_si256(south, north));
+        grown = _mm256_and_si256(grown, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(o + i)));
+        grown = _mm256_andnot_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)), grown);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(n + i), grown);
+    }
+#endif
+    for (; i < end; ++i) {
+        n[i] = grow(i) & o[i] & ~s[i];
+    }
+}
+
+void BitWavefront::spread(uint64_t* n, size_t tile, uint64_t bits) {
+    if (n[tile] == 0) {
+        touched.push_back(tile);
+    }
+    n[tile] |= bits;
+}
+
+void BitWavefront::settle(size_t tile, uint64_t bits, int level, Grid<int>& distances) {
+    seen[tile] |= bits;
+    nextActive.push_back(tile);
+    int x = static_cast<int>(tile % stride) * 8;
+    int y = static_cast<int>(tile / stride - 1) * 8;
+    int* cells = distances.data() + static_cast<size_t>(y) * width + x;
+    while (bits) {
+        int bit = lowestBit(bits);
+        cells[(bit >> 3) * width + (bit & 7)] = level;
+        bits &= bits - 1;
+    }
+}
+
+void BitWavefront::compute(const Grid<unsigned char>& moves, int source, Grid<int>& distances) {
+    if (distances.width() != moves.width() || distances.height() != moves.height()) {
+        distances = Grid<int>(moves.width(), moves.height());
+    }
+    distances.fill(-1);
+    distances[source] = 0;
+    if (moves[source] == 0) {
+        return; // Nothing leads out of the source
+    }
+    reshape(moves.width(), moves.height());
+
+    // A cell with any open move is open; with uniform masks that is exactly
+    // the set of cells that have neighbours to connect to.
+    uint64_t* o = open.begin();
+    for (size_t t = 0; t < open.size(); ++t) {
+        o[t] = 0;
+        seen[t] = 0;
+    }
+    for (int y = 0; y < height; ++y) {
+        uint64_t* tiles = o + (y / 8 + 1) * stride;
+        int shift = (y & 7) * 8;
+        const unsigned char* cells = moves.data() + static_cast<size_t>(y) * width;
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            tiles[x >> 3] |= static_cast<uint64_t>(nonZeroBytes(cells + x)) << shift;
+        }
+        for (; x < width; ++x) {
+            tiles[x >> 3] |= static_cast<uint64_t>(cells[x] != 0) << (shift + (x & 7));
+        }
+    }
+
+    int sourceX = moves.xOf(source);
+    int sourceY = moves.yOf(source);
+    size_t tile = (sourceY / 8 + 1) * stride + sourceX / 8;
+    uint64_t bit = static_cast<uint64_t>(1) << ((sourceY & 7) * 8 + (sourceX & 7));
+    frontier[tile] = bit;
+    seen[tile] = bit;
+    active.resize(0);
+    active.push_back(tile);
+    int tileRows = (height + 7) / 8;
+    int low = sourceY / 8;
+    int high = low;
+
+    for (int level = 1; !active.empty(); ++level) {
+        nextActive.resize(0);
+        int bandLow = low > 0 ? low - 1 : 0;
+        int bandHigh = high < tileRows - 1 ? high + 1 : tileRows - 1;
+        size_t begin = (bandLow + 1) * stride;
+        size_t end = (bandHigh + 2) * stride;
+        uint64_t* n = next.begin();
+
+        if (active.size() * 4 >= end - begin) {
+            sweep(begin, end);
+            for (size_t t = begin; t < end; ++t) {
+                if (n[t]) {
+                    settle(t, n[t], level, distances);
+                }
+            }
+        } else {
+            // Scatter each frontier tile into itself and, only where an
+            // edge row or column is set, into the neighbouring tile.
+            touched.resize(0);
+            for (size_t i = 0; i < active.size(); ++i) {
+                size_t t = active.begin()[i];
+                uint64_t f = frontier[t];
+                spread(n, t, ((f << 1) & ~column0) | ((f >> 1) & ~column7) | (f << 8) | (f >> 8));
+                if (f & column0) {
+                    spread(n, t - 1, (f & column0) << 7);
+                }
+                if (f & column7) {
+                    spread(n, t + 1, (f & column7) >> 7);
+                }
+                if (f & row0) {
+                    spread(n, t - stride, f << 56);
+                }
+                if (f >> 56) {
+                    spread(n, t + stride, f >> 56);
+                }
+            }
+            for (size_t i = 0; i < touched.size(); ++i) {
+                size_t t = touched.begin()[i];
+                uint64_t bits = n[t] & o[t] & ~seen[t];
+                n[t] = bits;
+                if (bits) {
+                    settle(t, bits, level, distances);
+                }
+            }
+        }
+
+        // The new level becomes the frontier; clearing the old frontier's
+        // tiles restores the all-zero `next`.
+        std::swap(frontier, next);
+        n = next.begin();
+        for (size_t i = 0; i < active.size(); ++i) {
+            n[active.begin()[i]] = 0;
+        }
+        std::swap(active, nextActive);
+        low = tileRows;
+        high = -1;
+        for (size_t i = 0; i < active.size(); ++i) {
+            int row = static_cast<int>(active.begin()[i] / stride) - 1;
+            low = row < low ? row : low;
+            high = row > high ? row : high;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+// wavefront.h
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include "grid.h"
+#include <cstddef>
+#include <cstdint>
+
+// Breadth-first distance field propagated over a bitmap of open cells. Each
+// 64-bit word holds an 8x8 tile, so one BFS level is
+// new = (shifts of frontier) & open & ~seen for up to 64 cells at once; with
+// AVX2 four tiles are handled per instruction. Square tiles matter: a
+// wavefront spreading diagonally crosses a tile along up to eight cells per
+// level, where it would meet a 64x1 row word in one or two.
+//
+// Only the tiles next to the frontier are touched while it is sparse, as in
+// a long maze corridor. Once it fills a good part of its tile rows the whole
+// band is swept instead, which is where the wide operations pay off.
+//
+// The bitmap only says which cells are open, so this needs move masks where
+// any two adjacent open cells are connected (dekstra's uniform case).
+class BitWavefront {
+public:
+    BitWavefront();
+
+    // Same contract as computeDistanceField().
+    void compute(const Grid<unsigned char>& moves, int source, Grid<int>& distances);
+
+private:
+    int width;
+    int height;
+    // Tile row ty is stored at row ty + 1 with `stride` tiles per row, the
+    // last at least one of them always empty, and an empty row above and
+    // below. Shifts can then read every neighbouring tile unchecked.
+    size_t stride;
+    MyVector<uint64_t> open;
+    MyVector<uint64_t> seen;
+    MyVector<uint64_t> frontier;
+    MyVector<uint64_t> next; // all zero between levels
+    MyVector<size_t> active;     // tiles of frontier that are non-zero
+    MyVector<size_t> nextActive;
+    MyVector<size_t> touched;    // tiles of `next` written this level
+
+    void reshape(int width, int height);
+    uint64_t grow(size_t tile) const;
+    void sweep(size_t begin, size_t end);
+    void spread(uint64_t* n, size_t tile, uint64_t bits);
+    void settle(size_t tile, uint64_t bits, int level, Grid<int>& distances);
+};
+
+#endif // WAVEFRONT_H